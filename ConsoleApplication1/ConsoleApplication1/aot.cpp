@@ -0,0 +1,630 @@
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+#include "aot.hpp"
+#include "evaluator.hpp"
+#include "inline_cache.hpp"
+#include "gc.hpp"
+
+namespace {
+
+// ====== CODE GENERATION ======
+
+const char* preamble = R"(// generated by generateCpp from a Monkey program, do not edit
+#include "aot_runtime.hpp"
+
+namespace {
+
+const AotRuntime* rt;
+
+inline bool failed(const ObjectRef& obj) {
+	return obj && obj->kind() == ObjectKind::Error;
+}
+
+inline bool truthy(const ObjectRef& obj) {
+	if (!obj) {
+		return false;
+	}
+
+	switch (obj->kind()) {
+	case ObjectKind::Boolean:
+		return static_cast<Boolean*>(obj.get())->value;
+	case ObjectKind::Null:
+		return false;
+	default:
+		return true;
+	}
+}
+
+inline int64_t integer(const ObjectRef& obj) {
+	return static_cast<Integer*>(obj.get())->value;
+}
+
+)";
+
+// a C++ string literal for value, every byte outside [A-Za-z0-9 ] as an octal escape
+std::string quote(const std::string& value) {
+	std::string quoted = "\"";
+	char escape[8];
+
+	for (unsigned char c : value) {
+		if (std::isalnum(c) || c == ' ') {
+			quoted += static_cast<char>(c);
+		}
+		else {
+			std::snprintf(escape, sizeof(escape), "\\%03o", c);
+			quoted += escape;
+		}
+	}
+
+	return quoted + "\"";
+}
+
+class CppGenerator {
+public:
+	explicit CppGenerator(Program* program) : program(program) {
+		forEachNode(program, [this](Node* node) {
+			size_t i = index.size();
+			index[node] = i;
+		});
+	}
+
+	std::string generate() {
+		std::ostringstream body;
+		out = &body;
+		inFunction = false;
+
+		line("ObjectRef program(const EnvironmentRef& env) {");
+		indent++;
+		line("Heap* heap = env->heap;");
+		line("ObjectRef result;");
+		statements(program->statements, false, "result");
+		line("return result;");
+		indent--;
+		line("}");
+
+		std::ostringstream source;
+		source << preamble << constants.str() << "\n" << declarations.str() << "\n";
+		for (const std::string& function : functions) {
+			source << function << "\n";
+		}
+		source << body.str() << "\n}\n\n";
+
+		source << "extern \"C\" int monkey_aot_link(const AotRuntime* runtime) {\n"
+			<< "\tif (runtime->abiVersion != MONKEY_AOT_ABI_VERSION || runtime->environmentSize != sizeof(Environment)\n"
+			<< "\t\t|| runtime->nodeCount != " << index.size() << " || runtime->sourceHash != " << programHash(program) << "ull) {\n"
+			<< "\t\treturn 0;\n"
+			<< "\t}\n\n"
+			<< "\trt = runtime;\n"
+			<< link.str()
+			<< "\treturn 1;\n"
+			<< "}\n\n";
+
+		source << "extern \"C\" void monkey_aot_unlink() {\n"
+			<< unlink.str()
+			<< "}\n\n";
+
+		source << "extern \"C\" void monkey_aot_run(const EnvironmentRef* env, ObjectRef* result) {\n"
+			<< "\t*result = program(*env);\n"
+			<< "}\n";
+
+		return source.str();
+	}
+
+private:
+	Program* program;
+	std::unordered_map<Node*, size_t> index;
+
+	std::ostringstream constants;    // namespace-scope constants, set by monkey_aot_link
+	std::ostringstream declarations; // forward declarations of the native bodies
+	std::ostringstream link;         // body of monkey_aot_link
+	std::ostringstream unlink;       // body of monkey_aot_unlink
+	std::vector<std::string> functions;
+
+	std::ostringstream* out = nullptr; // function being written
+	int indent = 0;
+	bool inFunction = false;
+	size_t temps = 0;
+	size_t constantCount = 0;
+	size_t functionCount = 0;
+
+	void line(const std::string& text) {
+		*out << std::string(indent, '\t') << text << "\n";
+	}
+
+	std::string temp() {
+		return "t" + std::to_string(temps++);
+	}
+
+	std::string node(Node* n, const char* type) {
+		return std::string("static_cast<") + type + "*>(rt->nodes[" + std::to_string(index.at(n)) + "])";
+	}
+
+	std::string constant(const std::string& init) {
+		std::string name = "k" + std::to_string(constantCount++);
+		constants << "ObjectRef " << name << ";\n";
+		link << "\t" << name << " = " << init << ";\n";
+		unlink << "\t" << name << " = nullptr;\n";
+		return name;
+	}
+
+	void returnIfFailed(const std::string& value) {
+		line("if (failed(" + value + ")) return " + value + ";");
+	}
+
+	// statements of a block or program; the value of the last one goes to target, or is
+	// returned when the block is in tail position
+	void statements(const std::vector<std::unique_ptr<Statement>>& stmts, bool tail, const std::string& target) {
+		for (size_t i = 0; i < stmts.size(); i++) {
+			Statement* stmt = stmts[i].get();
+			bool last = i + 1 == stmts.size();
+
+			if (auto* returnStmt = dynamic_cast<ReturnStatement*>(stmt)) {
+				// inside a function every return is in tail position
+				if (inFunction) {
+					tailExpression(returnStmt->value.get());
+				}
+				else {
+					line("return " + expression(returnStmt->value.get()) + ";");
+				}
+				return; // the rest of the block can't run
+			}
+
+			if (auto* letStmt = dynamic_cast<LetStatement*>(stmt)) {
+				std::string value = expression(letStmt->value.get());
+				line("rt->let(" + node(letStmt, "LetStatement") + ", env, " + value + ");");
+				if (last && tail) {
+					line("return nullptr;");
+				}
+				continue;
+			}
+
+			if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(stmt)) {
+				if (last && tail) {
+					tailExpression(exprStmt->value.get());
+					return;
+				}
+
+				std::string value = expression(exprStmt->value.get());
+				if (last) {
+					line(target + " = " + value + ";");
+				}
+			}
+		}
+
+		if (tail) {
+			line("return nullptr;");
+		}
+	}
+
+	// code that returns the value of expr from the native body, handing calls back as TailCalls
+	void tailExpression(Expression* expr) {
+		if (auto* callExpr = dynamic_cast<CallExpression*>(expr)) {
+			std::string fn, args;
+			callOperands(callExpr, fn, args);
+			line("return rt->tailCall(" + node(callExpr, "CallExpression") + ", std::move(" + fn + "), std::move("
+				+ args + "), heap);");
+			return;
+		}
+
+		if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			std::string condition = expression(ifExpr->condition.get());
+			line("if (truthy(" + condition + ")) {");
+			indent++;
+			statements(ifExpr->consequence->statements, true, "");
+			indent--;
+			line("}");
+			if (ifExpr->alternative) {
+				line("else {");
+				indent++;
+				statements(ifExpr->alternative->statements, true, "");
+				indent--;
+				line("}");
+			}
+			line("return nullptr;");
+			return;
+		}
+
+		line("return " + expression(expr) + ";");
+	}
+
+	// code computing expr; returns the variable holding its value, which is never an Error
+	std::string expression(Expression* expr) {
+		if (!expr) {
+			return "ObjectRef()";
+		}
+
+		if (auto* intLit = dynamic_cast<IntegerLiteral*>(expr)) {
+			return constant("rt->integer(nullptr, " + std::to_string(intLit->value) + "ll)");
+		}
+
+		if (auto* boolLit = dynamic_cast<BooleanLiteral*>(expr)) {
+			return constant(std::string("rt->boolean(nullptr, ") + (boolLit->value ? "true" : "false") + ")");
+		}
+
+		if (auto* stringLit = dynamic_cast<StringLiteral*>(expr)) {
+			std::string name = "s" + std::to_string(constantCount++);
+			constants << "const std::string " << name << " = " << quote(stringLit->value) << ";\n";
+
+			std::string t = temp();
+			line("ObjectRef " + t + " = rt->string(heap, " + name + ");");
+			return t;
+		}
+
+		if (auto* ident = dynamic_cast<Identifier*>(expr)) {
+			std::string t = temp();
+			line("ObjectRef " + t + " = rt->identifier(" + node(ident, "Identifier") + ", env);");
+			returnIfFailed(t);
+			return t;
+		}
+
+		if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+			std::string right = expression(prefixExpr->right.get());
+			std::string t = temp();
+			line("ObjectRef " + t + " = rt->prefix(" + node(prefixExpr, "PrefixExpression") + ", " + right + ", heap);");
+			returnIfFailed(t);
+			return t;
+		}
+
+		if (auto* infixExpr = dynamic_cast<InfixExpression*>(expr)) {
+			return infix(infixExpr);
+		}
+
+		if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			std::string condition = expression(ifExpr->condition.get());
+			std::string t = temp();
+			line("ObjectRef " + t + ";");
+			line("if (truthy(" + condition + ")) {");
+			indent++;
+			statements(ifExpr->consequence->statements, false, t);
+			indent--;
+			line("}");
+			if (ifExpr->alternative) {
+				line("else {");
+				indent++;
+				statements(ifExpr->alternative->statements, false, t);
+				indent--;
+				line("}");
+			}
+			return t;
+		}
+
+		if (auto* funcLit = dynamic_cast<FunctionLiteral*>(expr)) {
+			std::string name = function(funcLit);
+			link << "\t" << node(funcLit, "FunctionLiteral") << "->body->native = " << name << ";\n";
+			unlink << "\t" << node(funcLit, "FunctionLiteral") << "->body->native = nullptr;\n";
+
+			std::string t = temp();
+			line("ObjectRef " + t + " = rt->functionLiteral(" + node(funcLit, "FunctionLiteral") + ", env);");
+			return t;
+		}
+
+		if (auto* callExpr = dynamic_cast<CallExpression*>(expr)) {
+			std::string fn, args;
+			callOperands(callExpr, fn, args);
+
+			std::string t = temp();
+			line("ObjectRef " + t + " = rt->call(" + node(callExpr, "CallExpression") + ", std::move(" + fn
+				+ "), std::move(" + args + "), heap);");
+			returnIfFailed(t);
+			return t;
+		}
+
+		return "ObjectRef()";
+	}
+
+	std::string infix(InfixExpression* infixExpr) {
+		std::string left = expression(infixExpr->left.get());
+		std::string right = expression(infixExpr->right.get());
+		std::string t = temp();
+		line("ObjectRef " + t + ";");
+
+		// integer operations that can't fail are done in place, everything else goes through the interpreter
+		// (arithmetic wraps around like the interpreter's, through the helpers in object.hpp)
+		const char* result = nullptr;
+		const char* cpp = nullptr;
+		const char* helper = nullptr;
+		switch (infixExpr->op) {
+		case Operator::Plus: result = "integer"; helper = "wrappingAdd"; break;
+		case Operator::Minus: result = "integer"; helper = "wrappingSubtract"; break;
+		case Operator::Asterisk: result = "integer"; helper = "wrappingMultiply"; break;
+		case Operator::Lt: result = "boolean"; cpp = "<"; break;
+		case Operator::Gt: result = "boolean"; cpp = ">"; break;
+		case Operator::Eq: result = "boolean"; cpp = "=="; break;
+		case Operator::NotEq: result = "boolean"; cpp = "!="; break;
+		default: break;
+		}
+
+		std::string generic = t + " = rt->infix(" + node(infixExpr, "InfixExpression") + ", " + left + ", " + right + ", heap);";
+
+		if (result) {
+			line("if (" + left + " && " + right + " && " + left + "->kind() == ObjectKind::Integer && "
+				+ right + "->kind() == ObjectKind::Integer) {");
+			std::string value = helper
+				? std::string(helper) + "(integer(" + left + "), integer(" + right + "))"
+				: "integer(" + left + ") " + cpp + " integer(" + right + ")";
+			line(std::string("\t") + t + " = rt->" + result + "(heap, " + value + ");");
+			line("}");
+			line("else {");
+			indent++;
+			line(generic);
+			returnIfFailed(t);
+			indent--;
+			line("}");
+		}
+		else {
+			line(generic);
+			returnIfFailed(t);
+		}
+
+		return t;
+	}
+
+	void callOperands(CallExpression* callExpr, std::string& fn, std::string& args) {
+		fn = expression(callExpr->function.get());
+
+		std::vector<std::string> values;
+		for (const auto& arg : callExpr->arguments) {
+			values.push_back(expression(arg.get()));
+		}
+
+		args = temp();
+		line("std::vector<ObjectRef> " + args + ";");
+		line(args + ".reserve(" + std::to_string(values.size()) + ");");
+		for (const std::string& value : values) {
+			line(args + ".push_back(" + value + ");");
+		}
+	}
+
+	// writes the native body of funcLit and returns its name
+	std::string function(FunctionLiteral* funcLit) {
+		std::string name = "fn" + std::to_string(functionCount++);
+		declarations << "ObjectRef " << name << "(const EnvironmentRef& env);\n";
+
+		std::ostringstream body;
+		std::ostringstream* outer = out;
+		int outerIndent = indent;
+		bool outerInFunction = inFunction;
+		out = &body;
+		indent = 0;
+		inFunction = true;
+
+		line("ObjectRef " + name + "(const EnvironmentRef& env) {");
+		indent++;
+		line("Heap* heap = env->heap;");
+		statements(funcLit->body->statements, true, "");
+		indent--;
+		line("}");
+
+		out = outer;
+		indent = outerIndent;
+		inFunction = outerInFunction;
+
+		functions.push_back(body.str());
+		return name;
+	}
+};
+
+// ====== RUNTIME ======
+
+ObjectRef aotInteger(Heap* heap, int64_t value) {
+	return newObject<Integer>(heap, value);
+}
+
+ObjectRef aotBoolean(Heap* heap, bool value) {
+	return newObject<Boolean>(heap, value);
+}
+
+ObjectRef aotString(Heap* heap, const std::string& value) {
+	return newString(heap, value);
+}
+
+ObjectRef aotIdentifier(Identifier* ident, const EnvironmentRef& env) {
+	return evalIdentifier(ident, env);
+}
+
+void aotLet(LetStatement* letStmt, const EnvironmentRef& env, ObjectRef value) {
+	env->setObject(letStmt->name->symbol, std::move(value));
+}
+
+ObjectRef aotPrefix(PrefixExpression* prefixExpr, ObjectRef right, Heap* heap) {
+	return evalPrefixExpression(prefixExpr->op, std::move(right), heap);
+}
+
+ObjectRef aotInfix(InfixExpression* infixExpr, ObjectRef left, ObjectRef right, Heap* heap) {
+	return evalInfixNode(infixExpr, std::move(left), std::move(right), heap);
+}
+
+ObjectRef aotFunctionLiteral(FunctionLiteral* funcLit, const EnvironmentRef& env) {
+	return evalFunctionLiteral(funcLit, env);
+}
+
+ObjectRef aotCall(CallExpression* site, ObjectRef fn, std::vector<ObjectRef> args, Heap* heap) {
+	// same loop as the tree walker's applyFunction, running native bodies when there are some
+	while (true) {
+		if (!fn) {
+			return newObject<Error>(heap, ErrorCode::NotAFunction, Operator::Unknown, ObjectKind::Count, ObjectKind::Count);
+		}
+
+		Function* function = resolveCallee(site, fn.get());
+		if (!function) {
+			return newObject<Error>(heap, ErrorCode::NotAFunction, Operator::Unknown, fn->kind(), ObjectKind::Count);
+		}
+
+		if (!callFits(function)) {
+			return newObject<Error>(heap, ErrorCode::MemoryLimitExceeded);
+		}
+
+		EnvironmentRef env = extendFunctionEnv(function, args);
+		ObjectRef evaluated = function->body->native ? function->body->native(env) : eval(function->body, env);
+
+		if (evaluated && evaluated->kind() == ObjectKind::TailCall) {
+			TailCall* tailCall = static_cast<TailCall*>(evaluated.get());
+			fn = std::move(tailCall->function);
+			args = std::move(tailCall->arguments);
+			site = tailCall->site;
+			continue;
+		}
+
+		return unwrapReturnValue(std::move(evaluated));
+	}
+}
+
+ObjectRef aotTailCall(CallExpression* site, ObjectRef fn, std::vector<ObjectRef> args, Heap* heap) {
+	return newObject<TailCall>(heap, std::move(fn), std::move(args), site);
+}
+
+std::string readFile(const std::filesystem::path& path) {
+	std::ifstream in(path);
+	std::stringstream contents;
+	contents << in.rdbuf();
+	return contents.str();
+}
+
+}
+
+uint64_t programHash(Program* program) {
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned char c : program->string()) {
+		hash ^= c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::string generateCpp(Program* program) {
+	return CppGenerator(program).generate();
+}
+
+std::string defaultIncludeDir() {
+	if (const char* configured = std::getenv("MONKEY_INCLUDE_DIR")) {
+		return configured;
+	}
+
+#ifdef MONKEY_INCLUDE_DIR
+	return MONKEY_INCLUDE_DIR;
+#else
+	return "";
+#endif
+}
+
+std::unique_ptr<AotModule> AotModule::build(Program* program, const AotOptions& options, std::string& error) {
+#ifdef _WIN32
+	error = "native builds need dlopen, which this platform doesn't have";
+	return nullptr;
+#else
+	namespace fs = std::filesystem;
+	static std::atomic<unsigned> builds{ 0 };
+
+	std::error_code ec;
+	fs::path dir = options.workDir.empty() ? fs::temp_directory_path(ec) : fs::path(options.workDir);
+	if (options.includeDir.empty()) {
+		error = "no include directory for the native build: set MONKEY_INCLUDE_DIR or AotOptions::includeDir";
+		return nullptr;
+	}
+	fs::path include(options.includeDir);
+
+	std::ostringstream stem;
+	stem << "monkey_aot_" << std::hex << programHash(program) << "_" << std::dec << builds++;
+	fs::path source = dir / (stem.str() + ".cpp");
+	fs::path object = dir / (stem.str() + ".so");
+	fs::path log = dir / (stem.str() + ".log");
+
+	{
+		std::ofstream out(source);
+		out << generateCpp(program);
+		if (!out) {
+			error = "could not write " + source.string();
+			return nullptr;
+		}
+	}
+
+	std::string command = options.compiler + " " + options.flags + " -I\"" + include.string() + "\" -o \""
+		+ object.string() + "\" \"" + source.string() + "\" > \"" + log.string() + "\" 2>&1";
+	int status = std::system(command.c_str());
+
+	std::unique_ptr<AotModule> module(new AotModule());
+	if (status == 0) {
+		module->handle = dlopen(object.c_str(), RTLD_NOW | RTLD_LOCAL);
+		if (!module->handle) {
+			error = std::string("could not load the native build: ") + dlerror();
+		}
+	}
+	else {
+		error = "native build failed: " + readFile(log);
+	}
+
+	if (!options.keepFiles) {
+		fs::remove(source, ec);
+		fs::remove(object, ec);
+		fs::remove(log, ec);
+	}
+
+	if (!module->handle) {
+		return nullptr;
+	}
+
+	auto link = reinterpret_cast<AotLink>(dlsym(module->handle, "monkey_aot_link"));
+	module->unlink = reinterpret_cast<AotUnlink>(dlsym(module->handle, "monkey_aot_unlink"));
+	module->entry = reinterpret_cast<AotRun>(dlsym(module->handle, "monkey_aot_run"));
+	if (!link || !module->unlink || !module->entry) {
+		error = "native build is missing its entry points";
+		module->unlink = nullptr;
+		return nullptr;
+	}
+
+	forEachNode(program, [&module](Node* node) { module->nodes.push_back(node); });
+
+	AotRuntime& rt = module->runtime;
+	rt.abiVersion = MONKEY_AOT_ABI_VERSION;
+	rt.environmentSize = sizeof(Environment);
+	rt.nodes = module->nodes.data();
+	rt.nodeCount = module->nodes.size();
+	rt.sourceHash = programHash(program);
+	rt.integer = aotInteger;
+	rt.boolean = aotBoolean;
+	rt.string = aotString;
+	rt.identifier = aotIdentifier;
+	rt.let = aotLet;
+	rt.prefix = aotPrefix;
+	rt.infix = aotInfix;
+	rt.functionLiteral = aotFunctionLiteral;
+	rt.call = aotCall;
+	rt.tailCall = aotTailCall;
+
+	if (!link(&rt)) {
+		error = "native build was made from a different program or interpreter";
+		module->unlink = nullptr;
+		return nullptr;
+	}
+
+	return module;
+#endif
+}
+
+AotModule::~AotModule() {
+#ifndef _WIN32
+	if (unlink) {
+		unlink();
+	}
+
+	if (handle) {
+		dlclose(handle);
+	}
+#endif
+}
+
+ObjectRef AotModule::run(EnvironmentRef env) {
+	ObjectRef result;
+	entry(&env, &result);
+	return result;
+}
@@ -1,144 +1,219 @@
-#include <sstream>
-#include "ast.hpp"
-
-
-std::string Program::tokenLiteral() const{
-    if (!statements.empty()) {
-        return statements[0]->tokenLiteral();
-    }
-    else {
-        return "";
-    }
-}
-
-std::string Program::string() const {
-    std::ostringstream out;
-
-    for (const auto& s : statements) {
-        out << s->string();
-    }
-
-    return out.str();
-}
-
-std::string LetStatement::string() const {
-    std::ostringstream out;
-
-    out << tokenLiteral() << " ";
-    out << name->string();
-    out << "=";
-
-    if (value != nullptr) {
-        out << value->string();
-    }
-
-    out << ";";
-    return out.str();
-}
-
-std::string ReturnStatement::string() const {
-    std::ostringstream out;
-
-    out << tokenLiteral() << " ";
-
-    if (value != nullptr) {
-        out << value->string();
-    }
-
-    out << ";";
-    return out.str();
-}
-
-std::string ExpressionStatement::string() const {
-    std::ostringstream out;
-
-    if (value != nullptr) {
-        out << value->string();
-    }
-    
-    // out << ";";
-    return out.str();
-}
-
-std::string BlockStatement::string() const {
-    std::ostringstream out;
-
-    for (const auto& statement : statements) {
-        out << statement->string();
-    }
-
-    return out.str();
-}
-
-std::string PrefixExpression::string() const {
-    std::ostringstream out;
-
-    out << "(" << oper << right -> string() << ")";
-
-    return out.str();
-}
-
-std::string InfixExpression::string() const {
-    std::ostringstream out;
-
-    out << "(" << left->string() << " " +  oper + " " << right->string() << ")";
-
-    return out.str();
-}
-
-std::string IfExpression::string() const {
-    std::ostringstream out;
-
-    out << "if " << condition->string() << " " << consequence->string();
-
-    if (alternative != nullptr) {
-        out << "else " << alternative->string();
-    }
-
-    return out.str();
-}
-
-std::string FunctionLiteral::string() const {
-    std::ostringstream out;
-
-    out << tokenLiteral() << "(";
-
-    std::vector<std::string> params;
-
-    for (const auto& param : parameters)
-        params.push_back(param->string());
-
-    for (int i = 0; i < params.size(); i++) {
-        out << params[i];
-
-        if (i < params.size() - 1)
-            out << ",";
-    }
-
-    out << ")";
-    out << body->string();
-
-    return out.str();
-}
-
-std::string CallExpression::string() const {
-    std::ostringstream out;
-
-    std::vector<std::string> args;
-
-    for (const auto& arg : arguments) {
-        args.push_back(arg->string());
-    }
-
-    out << function->string() << "(";
-
-    for (int i = 0; i < args.size(); i++) {
-        out << args[i];
-
-        if (i < args.size() - 1)
-            out << ",";
-    }
-
-    out << ")";
-    return out.str();
-}
+#include <atomic>
+#include <sstream>
+#include <unordered_map>
+#include "ast.hpp"
+
+Operator toOperator(const std::string& literal) {
+    static const std::unordered_map<std::string, Operator> operators = {
+        {"+", Operator::Plus}, {"-", Operator::Minus}, {"*", Operator::Asterisk}, {"/", Operator::Slash},
+        {"<", Operator::Lt}, {">", Operator::Gt}, {"==", Operator::Eq}, {"!=", Operator::NotEq},
+        {"!", Operator::Bang},
+    };
+
+    auto it = operators.find(literal);
+    return it != operators.end() ? it->second : Operator::Unknown;
+}
+
+std::string operatorLiteral(Operator op) {
+    static const char* literals[] = { "+", "-", "*", "/", "<", ">", "==", "!=", "!", "?" };
+    return literals[static_cast<size_t>(op)];
+}
+
+void forEachNode(Node* node, const std::function<void(Node*)>& visit) {
+    if (!node) {
+        return;
+    }
+
+    visit(node);
+
+    if (auto* program = dynamic_cast<Program*>(node)) {
+        for (const auto& stmt : program->statements) {
+            forEachNode(stmt.get(), visit);
+        }
+    }
+    else if (auto* blockStmt = dynamic_cast<BlockStatement*>(node)) {
+        for (const auto& stmt : blockStmt->statements) {
+            forEachNode(stmt.get(), visit);
+        }
+    }
+    else if (auto* letStmt = dynamic_cast<LetStatement*>(node)) {
+        forEachNode(letStmt->name.get(), visit);
+        forEachNode(letStmt->value.get(), visit);
+    }
+    else if (auto* returnStmt = dynamic_cast<ReturnStatement*>(node)) {
+        forEachNode(returnStmt->value.get(), visit);
+    }
+    else if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(node)) {
+        forEachNode(exprStmt->value.get(), visit);
+    }
+    else if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(node)) {
+        forEachNode(prefixExpr->right.get(), visit);
+    }
+    else if (auto* infixExpr = dynamic_cast<InfixExpression*>(node)) {
+        forEachNode(infixExpr->left.get(), visit);
+        forEachNode(infixExpr->right.get(), visit);
+    }
+    else if (auto* ifExpr = dynamic_cast<IfExpression*>(node)) {
+        forEachNode(ifExpr->condition.get(), visit);
+        forEachNode(ifExpr->consequence.get(), visit);
+        forEachNode(ifExpr->alternative.get(), visit);
+    }
+    else if (auto* funcLit = dynamic_cast<FunctionLiteral*>(node)) {
+        for (const auto& param : funcLit->parameters) {
+            forEachNode(param.get(), visit);
+        }
+        forEachNode(funcLit->body.get(), visit);
+    }
+    else if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
+        forEachNode(callExpr->function.get(), visit);
+        for (const auto& arg : callExpr->arguments) {
+            forEachNode(arg.get(), visit);
+        }
+    }
+}
+
+FunctionCode::FunctionCode() {
+    static std::atomic<uint64_t> serials{ 1 };
+    serial = serials.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string Program::tokenLiteral() const{
+    if (!statements.empty()) {
+        return statements[0]->tokenLiteral();
+    }
+    else {
+        return "";
+    }
+}
+
+std::string Program::string() const {
+    std::ostringstream out;
+
+    for (const auto& s : statements) {
+        out << s->string();
+    }
+
+    return out.str();
+}
+
+std::string LetStatement::string() const {
+    std::ostringstream out;
+
+    out << tokenLiteral() << " ";
+    out << name->string();
+    out << "=";
+
+    if (value != nullptr) {
+        out << value->string();
+    }
+
+    out << ";";
+    return out.str();
+}
+
+std::string ReturnStatement::string() const {
+    std::ostringstream out;
+
+    out << tokenLiteral() << " ";
+
+    if (value != nullptr) {
+        out << value->string();
+    }
+
+    out << ";";
+    return out.str();
+}
+
+std::string ExpressionStatement::string() const {
+    std::ostringstream out;
+
+    if (value != nullptr) {
+        out << value->string();
+    }
+    
+    // out << ";";
+    return out.str();
+}
+
+std::string BlockStatement::string() const {
+    std::ostringstream out;
+
+    for (const auto& statement : statements) {
+        out << statement->string();
+    }
+
+    return out.str();
+}
+
+std::string PrefixExpression::string() const {
+    std::ostringstream out;
+
+    out << "(" << oper << right -> string() << ")";
+
+    return out.str();
+}
+
+std::string InfixExpression::string() const {
+    std::ostringstream out;
+
+    out << "(" << left->string() << " " +  oper + " " << right->string() << ")";
+
+    return out.str();
+}
+
+std::string IfExpression::string() const {
+    std::ostringstream out;
+
+    out << "if " << condition->string() << " " << consequence->string();
+
+    if (alternative != nullptr) {
+        out << "else " << alternative->string();
+    }
+
+    return out.str();
+}
+
+std::string FunctionLiteral::string() const {
+    std::ostringstream out;
+
+    out << tokenLiteral() << "(";
+
+    std::vector<std::string> params;
+
+    for (const auto& param : parameters)
+        params.push_back(param->string());
+
+    for (int i = 0; i < params.size(); i++) {
+        out << params[i];
+
+        if (i < params.size() - 1)
+            out << ",";
+    }
+
+    out << ")";
+    out << body->string();
+
+    return out.str();
+}
+
+std::string CallExpression::string() const {
+    std::ostringstream out;
+
+    std::vector<std::string> args;
+
+    for (const auto& arg : arguments) {
+        args.push_back(arg->string());
+    }
+
+    out << function->string() << "(";
+
+    for (int i = 0; i < args.size(); i++) {
+        out << args[i];
+
+        if (i < args.size() - 1)
+            out << ",";
+    }
+
+    out << ")";
+    return out.str();
+}
@@ -0,0 +1,749 @@
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <functional>
+#include <unordered_set>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "gc.hpp"
+#include "frames.hpp"
+#include "closures.hpp"
+#include "closure_compiler.hpp"
+#include "aot.hpp"
+#include "jit.hpp"
+#include "specializer.hpp"
+#include "memoizer.hpp"
+#include "optimizer.hpp"
+#include "type_inference.hpp"
+
+// ====== HELPER FUNCTIONS ======
+
+struct BenchResult {
+    double totalMs = 0;
+    double p50Us = 0;
+    double p99Us = 0;
+    size_t allocations = 0; // nursery allocations, only known when the nursery is on
+};
+
+static std::unique_ptr<Program> parse(const std::string& input) {
+    auto l = std::make_unique<Lexer>(input);
+    Parser p(l);
+    return p.parseProgram();
+}
+
+using Engine = std::function<ObjectRef(Node*, EnvironmentRef)>;
+
+// evaluates 'setup' once, then times 'iterations' evaluations of 'call' in the same interpreter.
+// 'prepare', when given, sees both programs before anything runs, and 'finish' runs before they go away
+static BenchResult runBenchmark(const std::string& setup, const std::string& call,
+    int iterations, const GcConfig& config, const std::function<void(Program*)>& prepare = nullptr,
+    const Engine& engine = eval, const std::function<void()>& finish = nullptr) {
+    Heap heap(config);
+    auto env = heap.newEnvironment(nullptr);
+    std::unique_ptr<Program> setupProgram = parse(setup);
+    std::unique_ptr<Program> callProgram = parse(call);
+    if (prepare) {
+        prepare(setupProgram.get());
+        prepare(callProgram.get());
+    }
+    engine(setupProgram.get(), env);
+
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        auto before = std::chrono::steady_clock::now();
+        ObjectRef result = engine(callProgram.get(), env);
+        auto after = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (finish) {
+        finish();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    BenchResult result;
+    result.totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+    result.p50Us = latencies[latencies.size() / 2];
+    result.p99Us = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+    result.allocations = heap.nurseryStats().allocations;
+    return result;
+}
+
+static void compareNursery(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    GcConfig withNursery;
+    withNursery.nursery = true;
+    GcConfig withoutNursery;
+
+    // warm up the allocator and caches before measuring
+    runBenchmark(setup, call, iterations / 10, withNursery);
+
+    BenchResult young = runBenchmark(setup, call, iterations, withNursery);
+    BenchResult old = runBenchmark(setup, call, iterations, withoutNursery);
+
+    auto report = [&](const char* label, const BenchResult& r) {
+        double throughput = young.allocations / (r.totalMs / 1000.0) / 1e6;
+        std::cout << "  " << std::left << std::setw(16) << label
+                  << std::fixed << std::setprecision(2)
+                  << "total " << std::setw(9) << r.totalMs << " ms  "
+                  << "p50 " << std::setw(8) << r.p50Us << " us  "
+                  << "p99 " << std::setw(8) << r.p99Us << " us  "
+                  << throughput << " M allocs/s\n";
+    };
+
+    std::cout << name << " (" << iterations << " runs, " << young.allocations << " allocations)\n";
+    report("nursery", young);
+    report("general heap", old);
+}
+
+static void reportRun(const char* label, const BenchResult& r) {
+    std::cout << "  " << std::left << std::setw(16) << label
+              << std::fixed << std::setprecision(2)
+              << "total " << std::setw(9) << r.totalMs << " ms  "
+              << "p50 " << std::setw(8) << r.p50Us << " us  "
+              << "p99 " << std::setw(8) << r.p99Us << " us\n";
+}
+
+// the same program with self-specializing infix nodes and with every node pinned to the generic path
+static void compareSpecialization(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    auto generic = [](Program* program) {
+        forEachNode(program, [](Node* node) {
+            if (auto* infixExpr = dynamic_cast<InfixExpression*>(node)) {
+                infixExpr->specialization.state = InfixSpecialization::State::Generic;
+            }
+        });
+    };
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult specialized = runBenchmark(setup, call, iterations, GcConfig());
+    BenchResult unspecialized = runBenchmark(setup, call, iterations, GcConfig(), generic);
+
+    std::cout << name << " (" << iterations << " runs)\n";
+    reportRun("specialized", specialized);
+    reportRun("generic", unspecialized);
+}
+
+// the tree walker against the closure compiler, which compiles each program once up front
+static void compareEngines(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    std::vector<std::pair<Node*, std::shared_ptr<const CompiledNode>>> compiled;
+    Engine closures = [&compiled](Node* node, EnvironmentRef env) {
+        for (const auto& [program, code] : compiled) {
+            if (program == node) {
+                return (*code)(env);
+            }
+        }
+        compiled.push_back({ node, compile(node) });
+        return (*compiled.back().second)(env);
+    };
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult tree = runBenchmark(setup, call, iterations, GcConfig());
+    BenchResult closure = runBenchmark(setup, call, iterations, GcConfig(), nullptr, closures);
+
+    std::cout << name << " (" << iterations << " runs)\n";
+    reportRun("tree walker", tree);
+    reportRun("closures", closure);
+}
+
+// the tree walker against native builds; the programs are built before the clock starts and the
+// build time is reported on its own
+static void compareNative(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    std::vector<std::pair<Node*, std::unique_ptr<AotModule>>> modules;
+    double buildMs = 0;
+    auto build = [&modules, &buildMs](Program* program) {
+        std::string error;
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<AotModule> module = AotModule::build(program, AotOptions(), error);
+        buildMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!module) {
+            std::cerr << error << "\n";
+        }
+        modules.push_back({ program, std::move(module) });
+    };
+    Engine native = [&modules](Node* node, EnvironmentRef env) -> ObjectRef {
+        for (const auto& [program, module] : modules) {
+            if (program == node && module) {
+                return module->run(env);
+            }
+        }
+        return eval(node, env);
+    };
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult tree = runBenchmark(setup, call, iterations, GcConfig());
+    // modules are unlinked while the programs they were built from are still around
+    BenchResult aot = runBenchmark(setup, call, iterations, GcConfig(), build, native, [&modules]() { modules.clear(); });
+
+    std::cout << name << " (" << iterations << " runs, " << std::fixed << std::setprecision(0)
+              << buildMs << " ms to build)\n";
+    reportRun("tree walker", tree);
+    reportRun("native", aot);
+}
+
+// the tree walker with and without tiering hot functions up to machine code
+static void compareJit(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    GcConfig jitting;
+    jitting.jit.enabled = true;
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult tree = runBenchmark(setup, call, iterations, GcConfig());
+
+    JitStats before = jitStats;
+    BenchResult jit = runBenchmark(setup, call, iterations, jitting);
+
+    std::cout << name << " (" << iterations << " runs, " << jitStats.nativeCalls - before.nativeCalls
+              << " native calls)\n";
+    reportRun("tree walker", tree);
+    reportRun("jit", jit);
+}
+
+// the same program as parsed and after -O2, whose typed expressions are computed unboxed
+static void compareTyping(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    TypeCoverage coverage;
+    auto optimize = [&coverage](Program* program) {
+        PassManager(2).run(*program);
+        coverage += collectTypeCoverage(program);
+    };
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult boxed = runBenchmark(setup, call, iterations, GcConfig());
+    BenchResult unboxed = runBenchmark(setup, call, iterations, GcConfig(), optimize);
+
+    std::cout << name << " (" << iterations << " runs, " << coverage.typed << " of "
+              << coverage.expressions << " expressions typed)\n";
+    reportRun("boxed", boxed);
+    reportRun("unboxed", unboxed);
+}
+
+static void compareInlining(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    size_t inlined = 0;
+    auto optimize = [](Program* program) {
+        PassManager(1).run(*program);
+    };
+    auto optimizeAndCount = [&inlined](Program* program) {
+        PassManager passManager(2);
+        passManager.run(*program);
+        for (const PassStats& stats : passManager.stats()) {
+            if (stats.name == "function-inlining") {
+                inlined += stats.rewrites;
+            }
+        }
+    };
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult called = runBenchmark(setup, call, iterations, GcConfig(), optimize);
+    BenchResult expanded = runBenchmark(setup, call, iterations, GcConfig(), optimizeAndCount);
+
+    std::cout << name << " (" << iterations << " runs, " << inlined << " call sites inlined)\n";
+    reportRun("-O1 calls", called);
+    reportRun("-O2 inlined", expanded);
+}
+
+// the same program with calls made as written and through residuals for their constant arguments
+static void comparePartialEvaluation(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    GcConfig specializing;
+    specializing.specializer.enabled = true;
+    auto optimize = [](Program* program) {
+        PassManager(1).run(*program);
+    };
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult general = runBenchmark(setup, call, iterations, GcConfig(), optimize);
+
+    SpecializerStats before = specializerStats;
+    BenchResult specialized = runBenchmark(setup, call, iterations, specializing, optimize);
+
+    std::cout << name << " (" << iterations << " runs, " << specializerStats.calls - before.calls
+              << " specialized calls)\n";
+    reportRun("general", general);
+    reportRun("specialized", specialized);
+}
+
+// the same program with every call made, and with calls of pure functions answered from their memo tables.
+// Tables persist across runs like a REPL session's would, so only the first run fills them
+static void compareMemoization(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    GcConfig memoizing;
+    memoizing.memo.enabled = true;
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult plain = runBenchmark(setup, call, iterations, GcConfig());
+
+    MemoStats before = memoStats;
+    BenchResult memoized = runBenchmark(setup, call, iterations, memoizing);
+
+    MemoStats stats;
+    stats.hits = memoStats.hits - before.hits;
+    stats.misses = memoStats.misses - before.misses;
+    std::cout << name << " (" << iterations << " runs)\n";
+    reportRun("every call", plain);
+    reportRun("memoized", memoized);
+    std::cout << "  ";
+    printMemoStats(std::cout, stats);
+}
+
+// the same calls binding few names, which stay in the environment, and many, which move to its table
+static void compareFrames(const std::string& name, const std::string& few, const std::string& many,
+    const std::string& call, int iterations) {
+    runBenchmark(few, call, iterations / 10, GcConfig());
+
+    BenchResult inlineFrames = runBenchmark(few, call, iterations, GcConfig());
+    BenchResult tableFrames = runBenchmark(many, call, iterations, GcConfig());
+
+    std::cout << name << " (" << iterations << " runs)\n";
+    reportRun("inline bindings", inlineFrames);
+    reportRun("table bindings", tableFrames);
+}
+
+// the same calls reusing the frames of returned calls and allocating a new one each time
+static void compareFramePool(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    // every frame on the heap, as if each could escape
+    GcConfig pooled;
+    pooled.frames.enabled = false;
+    GcConfig fresh = pooled;
+    fresh.framePool = 0;
+
+    runBenchmark(setup, call, iterations / 10, pooled);
+
+    BenchResult reused = runBenchmark(setup, call, iterations, pooled);
+    BenchResult allocated = runBenchmark(setup, call, iterations, fresh);
+
+    std::cout << name << " (" << iterations << " runs)\n";
+    reportRun("pooled frames", reused);
+    reportRun("fresh frames", allocated);
+}
+
+// bytes of the environments a closure keeps alive besides the global one, and of the strings
+// bound in them
+static size_t retainedBytes(const ObjectRef& value) {
+    std::unordered_set<const Environment*> seen;
+    std::vector<const Object*> pending{ value.get() };
+    size_t bytes = 0;
+
+    while (!pending.empty()) {
+        const Object* obj = pending.back();
+        pending.pop_back();
+
+        switch (kindOf(obj)) {
+        case ObjectKind::Upvalue:
+            pending.push_back(static_cast<const Upvalue*>(obj)->value.get());
+            break;
+        case ObjectKind::String:
+            bytes += sizeof(String) + static_cast<const String*>(obj)->value.capacity();
+            break;
+        case ObjectKind::Function:
+            for (Environment* env = static_cast<const Function*>(obj)->env.get();
+                env && env->outer && seen.insert(env).second; env = env->outer.get()) {
+                bytes += sizeof(Environment) + env->store.tableBytes();
+                for (const auto& [symbol, bound] : env->store) {
+                    pending.push_back(bound.get());
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return bytes;
+}
+
+static void compareCaptures(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    size_t retained[2];
+    BenchResult runs[2];
+    for (bool capture : { true, false }) {
+        GcConfig config;
+        config.capture.enabled = capture;
+        runs[capture] = runBenchmark(setup, call, iterations, config);
+
+        Heap heap(config);
+        auto env = heap.newEnvironment(nullptr);
+        std::unique_ptr<Program> setupProgram = parse(setup);
+        std::unique_ptr<Program> callProgram = parse(call);
+        eval(setupProgram.get(), env);
+        retained[capture] = retainedBytes(eval(callProgram.get(), env));
+    }
+
+    std::cout << name << " (" << iterations << " runs)\n";
+    reportRun("upvalues", runs[true]);
+    reportRun("whole frames", runs[false]);
+    std::cout << "  result retains " << retained[true] << " bytes with upvalues, "
+              << retained[false] << " with whole frames\n";
+}
+
+static void compareStackFrames(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    GcConfig heapFrames;
+    heapFrames.frames.enabled = false;
+
+    runBenchmark(setup, call, iterations / 10, GcConfig());
+
+    BenchResult stacked = runBenchmark(setup, call, iterations, GcConfig());
+    BenchResult pooled = runBenchmark(setup, call, iterations, heapFrames);
+
+    std::cout << name << " (" << iterations << " runs)\n";
+    reportRun("frame stack", stacked);
+    reportRun("heap frames", pooled);
+}
+
+// times 'iterations' rounds of taking 'copies' handles to one value and dropping them again, the
+// traffic an evaluation makes passing values and environments around
+template <typename Handle>
+static BenchResult runHandleTraffic(const Handle& value, int copies, int iterations) {
+    std::vector<Handle> held;
+    held.reserve(copies);
+
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        auto before = std::chrono::steady_clock::now();
+        for (int c = 0; c < copies; c++) {
+            held.push_back(value);
+        }
+        held.clear();
+        auto after = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::sort(latencies.begin(), latencies.end());
+
+    BenchResult result;
+    result.totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+    result.p50Us = latencies[latencies.size() / 2];
+    result.p99Us = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+    return result;
+}
+
+// @brief a handle counted like ObjectRef, but through a std::atomic as a count shared between
+// threads has to be. std::shared_ptr would skip the atomic instructions while this process has a
+// single thread, which is all the benchmark runs on
+class AtomicHandle {
+public:
+    explicit AtomicHandle(std::atomic<uint32_t>& counter) : count(&counter) {
+        count->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    AtomicHandle(const AtomicHandle& other) : count(other.count) {
+        count->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    AtomicHandle& operator=(const AtomicHandle&) = delete;
+
+    ~AtomicHandle() {
+        count->fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+private:
+    std::atomic<uint32_t>* count;
+};
+
+// the same handle traffic through ObjectRef, whose count is a plain integer in the object, and
+// through a handle whose count is atomic
+static void compareRefCounting(const std::string& name, const std::string& setup,
+    const std::string& call, int copies, int iterations) {
+    Heap heap;
+    auto env = heap.newEnvironment(nullptr);
+    std::unique_ptr<Program> setupProgram = parse(setup);
+    std::unique_ptr<Program> callProgram = parse(call);
+    eval(setupProgram.get(), env);
+    ObjectRef value = eval(callProgram.get(), env);
+    std::atomic<uint32_t> counter{ 0 };
+    AtomicHandle shared(counter);
+
+    runHandleTraffic(value, copies, iterations / 10);
+
+    BenchResult local = runHandleTraffic(value, copies, iterations);
+    BenchResult atomic = runHandleTraffic(shared, copies, iterations);
+    BenchResult whole = runBenchmark(setup, call, iterations, GcConfig());
+
+    std::cout << name << " (" << iterations << " runs of " << copies << " handles)\n";
+    reportRun("plain count", local);
+    reportRun("atomic count", atomic);
+    reportRun("evaluation", whole);
+}
+
+// resident set size of this process in KB, from /proc; 0 where that isn't available
+static size_t residentKb() {
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    size_t kb = 0;
+    while (status >> key) {
+        if (key == "VmRSS:") {
+            status >> kb;
+            break;
+        }
+        status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    return kb;
+}
+
+// runs 'lines' one at a time like a REPL session, through -O1 and the tree walker, and reports
+// the resident set every tenth of the way. Programs are dropped after they run unless keepPrograms
+static void soakRepl(const std::string& name, const std::vector<std::string>& lines, size_t evaluations,
+    bool keepPrograms) {
+    Heap heap;
+    auto env = heap.newEnvironment(nullptr);
+    PassManager passManager(1);
+    std::vector<std::unique_ptr<Program>> programs;
+
+    std::cout << name << " (" << evaluations << " lines, programs "
+              << (keepPrograms ? "kept" : "dropped") << ")\n  RSS KB:";
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < evaluations; i++) {
+        std::unique_ptr<Program> program = parse(lines[i % lines.size()]);
+        passManager.run(*program);
+        eval(program.get(), env);
+        if (keepPrograms) {
+            programs.push_back(std::move(program));
+        }
+
+        if ((i + 1) % (evaluations / 10) == 0) {
+            std::cout << " " << residentKb();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "\n  total " << std::fixed << std::setprecision(2)
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+}
+
+// the same program without a memory limit and with one it stays under, which is checked before
+// every call and concatenation
+static void compareMemoryLimit(const std::string& name, const std::string& setup,
+    const std::string& call, int iterations) {
+    GcConfig unlimited;
+    GcConfig limited;
+    limited.memoryLimit = 64 * 1024 * 1024;
+
+    runBenchmark(setup, call, iterations / 10, unlimited);
+
+    BenchResult free = runBenchmark(setup, call, iterations, unlimited);
+    BenchResult capped = runBenchmark(setup, call, iterations, limited);
+
+    std::cout << name << " (" << iterations << " runs)\n";
+    reportRun("no limit", free);
+    reportRun("64 MB limit", capped);
+}
+
+// ====== BENCHMARKS ======
+
+static void BenchmarkNurseryArithmetic() {
+    compareNursery("arithmetic",
+        "let poly = fn(n, acc) { if (n < 1) { acc } else { poly(n - 1, acc + n * n * 3 - n / 2 + 7) } };",
+        "poly(200, 0)", 2000);
+}
+
+static void BenchmarkNurseryStringBuilding() {
+    compareNursery("string building",
+        R"(let build = fn(n, acc) { if (n < 1) { acc } else { build(n - 1, acc + "ab" + "c") } };)",
+        "build(60, \"\")", 2000);
+}
+
+static void BenchmarkInfixSpecialization() {
+    compareSpecialization("integer arithmetic",
+        "let poly = fn(n, acc) { if (n < 1) { acc } else { poly(n - 1, acc + n * n * 3 - n / 2 + 7) } };",
+        "poly(200, 0)", 2000);
+    compareSpecialization("comparisons",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(15)", 200);
+}
+
+static void BenchmarkClosureCompiler() {
+    compareEngines("integer arithmetic",
+        "let poly = fn(n, acc) { if (n < 1) { acc } else { poly(n - 1, acc + n * n * 3 - n / 2 + 7) } };",
+        "poly(200, 0)", 2000);
+    compareEngines("recursive calls",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(15)", 200);
+}
+
+static void BenchmarkAheadOfTime() {
+    compareNative("integer arithmetic",
+        "let poly = fn(n, acc) { if (n < 1) { acc } else { poly(n - 1, acc + n * n * 3 - n / 2 + 7) } };",
+        "poly(200, 0)", 2000);
+    compareNative("recursive calls",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(15)", 200);
+}
+
+static void BenchmarkJit() {
+    compareJit("integer arithmetic",
+        "let poly = fn(n, acc) { if (n < 1) { acc } else { poly(n - 1, acc + n * n * 3 - n / 2 + 7) } };",
+        "poly(200, 0)", 2000);
+    compareJit("recursive calls",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(15)", 200);
+}
+
+static void BenchmarkTypeInference() {
+    compareTyping("typed locals",
+        "let area = fn(n) { let w = 12; let h = 7; let a = w * h + w - h * 3; let b = (w + h) * (w - h) - a / 2; "
+        "if (a * b > 1000 == (w < h)) { n } else { a * b - w * w + h * h } };",
+        "area(1) + area(2)", 20000);
+}
+
+static void BenchmarkFunctionInlining() {
+    compareInlining("small helpers",
+        "let add = fn(a, b) { a + b }; let sq = fn(a) { a * a }; "
+        "let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, acc + add(n, 1) * sq(n)) } };",
+        "sum(200, 0)", 2000);
+}
+
+static void BenchmarkPartialEvaluation() {
+    comparePartialEvaluation("configuration flags",
+        "let scale = fn(mode, unit, x) { if (mode == 1) { x * unit } else { if (mode == 2) { x * unit * unit } else { x + unit } } }; "
+        "let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, acc + scale(2, 3, n)) } };",
+        "let n = 200; sum(n, 0)", 2000);
+}
+
+static void BenchmarkMemoization() {
+    compareMemoization("naive fibonacci",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(18)", 200);
+}
+
+static void BenchmarkCallFrames() {
+    compareFrames("small helpers",
+        "let add = fn(a, b) { a + b }; "
+        "let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, add(acc, n)) } };",
+        "let add = fn(a, b) { let c = a; let d = b; let e = c; let g = d; let h = e; a + b }; "
+        "let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, add(acc, n)) } };",
+        "sum(500, 0)", 1000);
+    compareFrames("recursive calls",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "let fib = fn(n) { let a = n; let b = n; let c = n; let d = n; let e = n; let g = n; "
+        "if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(15)", 200);
+}
+
+static void BenchmarkFramePool() {
+    compareFramePool("small helpers",
+        "let add = fn(a, b) { a + b }; "
+        "let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, add(acc, n)) } };",
+        "sum(500, 0)", 1000);
+    compareFramePool("recursive calls",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(15)", 200);
+}
+
+static void BenchmarkStackFrames() {
+    compareStackFrames("small helpers",
+        "let add = fn(a, b) { a + b }; "
+        "let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, add(acc, n)) } };",
+        "sum(500, 0)", 1000);
+    compareStackFrames("recursive calls",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(15)", 200);
+    compareStackFrames("closures made on the way",
+        "let twice = fn(f, x) { f(f(x)) }; "
+        "let walk = fn(n, acc) { if (n < 1) { acc } else { walk(n - 1, twice(fn(v) { v + n }, acc)) } };",
+        "walk(300, 0)", 500);
+}
+
+static void BenchmarkClosureCaptures() {
+    // every link keeps its predecessor, and with whole frames the padding built next to it
+    compareCaptures("closure chain",
+        "let chain = fn(n, prev) { if (n < 1) { prev } else { "
+        "let pad = \"................................................................\" + \"!\"; "
+        "chain(n - 1, fn() { prev() + 1 }) } };",
+        "chain(200, fn() { 0 })", 500);
+    compareCaptures("small closure of a big frame",
+        "let summary = fn(text) { let doubled = text + text; let all = doubled + doubled + text; "
+        "let size = 5; fn() { size } };",
+        "summary(\"................................................................\")", 20000);
+}
+
+static void BenchmarkRefCounting() {
+    compareRefCounting("integer result",
+        "let add = fn(a, b) { a + b }; "
+        "let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, add(acc, n)) } };",
+        "sum(500, 0)", 1000, 1000);
+    compareRefCounting("string result",
+        "let repeat = fn(s, n) { if (n < 1) { s } else { repeat(s + \"ab\", n - 1) } };",
+        "repeat(\"\", 100)", 1000, 1000);
+}
+
+static void BenchmarkReplSoak() {
+    // functions are redefined, closed over and called from later lines all the time
+    std::vector<std::string> lines = {
+        "let make = fn(x) { fn(y) { x + y } };",
+        "let add = make(3);",
+        "let total = add(1) + make(2)(3);",
+        "let pick = fn(a, b) { if (a < b) { a } else { b } }; pick(total, 7)",
+        "let greet = fn(name) { \"hello \" + name }; greet(\"monkey\")",
+        "let apply = fn(f, v) { f(v) }; apply(add, total)",
+    };
+    soakRepl("redefining session", lines, 1000000, false);
+    soakRepl("redefining session", lines, 100000, true);
+}
+
+static void BenchmarkMemoryLimit() {
+    compareMemoryLimit("recursive calls",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };",
+        "fib(15)", 200);
+    compareMemoryLimit("string building",
+        "let build = fn(s, n) { if (n < 1) { s } else { build(s + \"abcdefgh\", n - 1) } };",
+        "build(\"\", 200)", 2000);
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    BenchmarkNurseryArithmetic();
+//    BenchmarkNurseryStringBuilding();
+//    BenchmarkInfixSpecialization();
+//    BenchmarkClosureCompiler();
+//    BenchmarkAheadOfTime();
+//    BenchmarkJit();
+//    BenchmarkTypeInference();
+//    BenchmarkFunctionInlining();
+//    BenchmarkPartialEvaluation();
+//    BenchmarkMemoization();
+//    BenchmarkCallFrames();
+//    BenchmarkFramePool();
+//    BenchmarkStackFrames();
+//    BenchmarkClosureCaptures();
+//    BenchmarkRefCounting();
+//    BenchmarkReplSoak();
+//    BenchmarkMemoryLimit();
+//    return 0;
+//}
@@ -0,0 +1,381 @@
+#include "closure_compiler.hpp"
+#include "evaluator.hpp"
+#include "inline_cache.hpp"
+#include "gc.hpp"
+
+namespace {
+
+using EnvRef = const EnvironmentRef&;
+
+CompiledNode compileNode(Node* node, bool tail);
+
+bool stopsBlock(Object* result) {
+	if (!result) {
+		return false;
+	}
+
+	ObjectKind kind = result->kind();
+	return kind == ObjectKind::ReturnValue || kind == ObjectKind::TailCall || kind == ObjectKind::Error;
+}
+
+bool isErrorKind(Object* obj) {
+	return obj && obj->kind() == ObjectKind::Error;
+}
+
+const CompiledNode& compiledBody(BlockStatement* body) {
+	// functions created by eval reach here with a body that was never compiled
+	if (!body->compiledBody) {
+		body->compiledBody = std::make_shared<const CompiledNode>(compileNode(body, true));
+	}
+
+	return *body->compiledBody;
+}
+
+ObjectRef callFunction(ObjectRef fn, std::vector<ObjectRef> args, CallExpression* site, Heap* heap) {
+	// same loop as the tree walker's applyFunction: calls in tail position come back as a TailCall
+	while (true) {
+		if (!fn) {
+			return newObject<Error>(heap, ErrorCode::NotAFunction, Operator::Unknown, ObjectKind::Count, ObjectKind::Count);
+		}
+
+		Function* function = resolveCallee(site, fn.get());
+		if (!function) {
+			return newObject<Error>(heap, ErrorCode::NotAFunction, Operator::Unknown, fn->kind(), ObjectKind::Count);
+		}
+
+		if (!callFits(function)) {
+			return newObject<Error>(heap, ErrorCode::MemoryLimitExceeded);
+		}
+
+		const CompiledNode& body = compiledBody(function->body);
+		ObjectRef evaluated = body(extendFunctionEnv(function, args));
+
+		if (evaluated && evaluated->kind() == ObjectKind::TailCall) {
+			TailCall* tailCall = static_cast<TailCall*>(evaluated.get());
+			fn = std::move(tailCall->function);
+			args = std::move(tailCall->arguments);
+			site = tailCall->site;
+			continue;
+		}
+
+		return unwrapReturnValue(std::move(evaluated));
+	}
+}
+
+// ====== RUN FUNCTIONS ======
+
+ObjectRef runProgram(const CompiledNode& self, EnvRef env) {
+	ObjectRef result;
+
+	for (const CompiledNode& stmt : self.children) {
+		result = stmt(env);
+
+		if (result && result->kind() == ObjectKind::ReturnValue) {
+			return std::move(static_cast<ReturnValue*>(result.get())->value);
+		}
+
+		if (isErrorKind(result.get())) {
+			return result;
+		}
+	}
+
+	return result;
+}
+
+ObjectRef runBlock(const CompiledNode& self, EnvRef env) {
+	ObjectRef result;
+
+	for (const CompiledNode& stmt : self.children) {
+		result = stmt(env);
+
+		if (stopsBlock(result.get())) {
+			return result;
+		}
+	}
+
+	return result;
+}
+
+ObjectRef runConstant(const CompiledNode& self, EnvRef) {
+	return self.constant;
+}
+
+ObjectRef runString(const CompiledNode& self, EnvRef env) {
+	// strings go through newString so big ones are still pretenured on the session's heap
+	return newString(env->heap, static_cast<StringLiteral*>(self.node)->value);
+}
+
+ObjectRef runIdentifier(const CompiledNode& self, EnvRef env) {
+	auto* ident = static_cast<Identifier*>(self.node);
+
+	const ObjectRef* entry = lookupIdentifier(ident, env.get());
+	if (!entry) {
+		return newObject<Error>(env->heap, ErrorCode::IdentifierNotFound, ident->value);
+	}
+
+	return *entry;
+}
+
+ObjectRef runLet(const CompiledNode& self, EnvRef env) {
+	ObjectRef val = self.children[0](env);
+	if (isErrorKind(val.get())) {
+		return val;
+	}
+
+	env->setObject(static_cast<LetStatement*>(self.node)->name->symbol, std::move(val));
+	return nullptr;
+}
+
+ObjectRef runReturn(const CompiledNode& self, EnvRef env) {
+	ObjectRef val = self.children[0](env);
+	if (isErrorKind(val.get())) {
+		return val;
+	}
+
+	return newObject<ReturnValue>(env->heap, std::move(val));
+}
+
+// a return whose value was compiled in tail position may hand back a TailCall, which passes through
+ObjectRef runTailReturn(const CompiledNode& self, EnvRef env) {
+	ObjectRef val = self.children[0](env);
+	if (val && (val->kind() == ObjectKind::Error || val->kind() == ObjectKind::TailCall)) {
+		return val;
+	}
+
+	return newObject<ReturnValue>(env->heap, std::move(val));
+}
+
+ObjectRef runPrefix(const CompiledNode& self, EnvRef env) {
+	ObjectRef right = self.children[0](env);
+	if (isErrorKind(right.get())) {
+		return right;
+	}
+
+	return evalPrefixExpression(static_cast<PrefixExpression*>(self.node)->op, std::move(right), env->heap);
+}
+
+ObjectRef runInfix(const CompiledNode& self, EnvRef env) {
+	auto* infixExpr = static_cast<InfixExpression*>(self.node);
+	InfixSpecialization& spec = infixExpr->specialization;
+
+	ObjectRef left = self.children[0](env);
+
+	// as in eval: operands passing a specialized node's guard can't be errors
+	if (spec.state == InfixSpecialization::State::Specialized && left && left->kind() == spec.left) {
+		ObjectRef right = self.children[1](env);
+		if (right && right->kind() == spec.right) {
+			return spec.kernel(infixExpr->op, left.get(), right.get(), env->heap);
+		}
+
+		if (isErrorKind(right.get())) {
+			return right;
+		}
+
+		return evalInfixNode(infixExpr, std::move(left), std::move(right), env->heap);
+	}
+
+	if (isErrorKind(left.get())) {
+		return left;
+	}
+
+	ObjectRef right = self.children[1](env);
+	if (isErrorKind(right.get())) {
+		return right;
+	}
+
+	return evalInfixNode(infixExpr, std::move(left), std::move(right), env->heap);
+}
+
+ObjectRef runIf(const CompiledNode& self, EnvRef env) {
+	ObjectRef condition = self.children[0](env);
+	if (isErrorKind(condition.get())) {
+		return condition;
+	}
+
+	if (isTruthy(condition.get())) {
+		return self.children[1](env);
+	}
+
+	if (self.children.size() > 2) {
+		return self.children[2](env);
+	}
+
+	return nullptr;
+}
+
+ObjectRef runFunctionLiteral(const CompiledNode& self, EnvRef env) {
+	return evalFunctionLiteral(static_cast<FunctionLiteral*>(self.node), env);
+}
+
+// evaluates callee and arguments; false (with the error in 'error') when one of them fails
+bool evalCall(const CompiledNode& self, EnvRef env, ObjectRef& fn, std::vector<ObjectRef>& args, ObjectRef& error) {
+	fn = self.children[0](env);
+	if (isErrorKind(fn.get())) {
+		error = std::move(fn);
+		return false;
+	}
+
+	args.reserve(self.children.size() - 1);
+	for (size_t i = 1; i < self.children.size(); i++) {
+		ObjectRef arg = self.children[i](env);
+		if (isErrorKind(arg.get())) {
+			error = std::move(arg);
+			return false;
+		}
+
+		args.push_back(std::move(arg));
+	}
+
+	return true;
+}
+
+ObjectRef runCall(const CompiledNode& self, EnvRef env) {
+	ObjectRef fn, error;
+	std::vector<ObjectRef> args;
+	if (!evalCall(self, env, fn, args, error)) {
+		return error;
+	}
+
+	return callFunction(std::move(fn), std::move(args), static_cast<CallExpression*>(self.node), env->heap);
+}
+
+ObjectRef runTailCall(const CompiledNode& self, EnvRef env) {
+	ObjectRef fn, error;
+	std::vector<ObjectRef> args;
+	if (!evalCall(self, env, fn, args, error)) {
+		return error;
+	}
+
+	return newObject<TailCall>(env->heap, std::move(fn), std::move(args), static_cast<CallExpression*>(self.node));
+}
+
+// ====== COMPILER ======
+
+CompiledNode make(CompiledNode::Run run, Node* node) {
+	CompiledNode compiled;
+	compiled.run = run;
+	compiled.node = node;
+	return compiled;
+}
+
+CompiledNode constant(ObjectRef value) {
+	CompiledNode compiled = make(runConstant, nullptr);
+	compiled.constant = std::move(value);
+	return compiled;
+}
+
+// tail = the block is a function body, or a branch of an if in tail position of one
+CompiledNode compileBlock(const std::vector<std::unique_ptr<Statement>>& statements, Node* node, bool tail) {
+	CompiledNode compiled = make(runBlock, node);
+
+	for (size_t i = 0; i < statements.size(); i++) {
+		Statement* stmt = statements[i].get();
+		bool last = i + 1 == statements.size();
+
+		if (tail && dynamic_cast<ReturnStatement*>(stmt)) {
+			CompiledNode returnStmt = make(runTailReturn, stmt);
+			returnStmt.children.push_back(compileNode(static_cast<ReturnStatement*>(stmt)->value.get(), true));
+			compiled.children.push_back(std::move(returnStmt));
+		}
+		else {
+			compiled.children.push_back(compileNode(stmt, tail && last));
+		}
+	}
+
+	return compiled;
+}
+
+CompiledNode compileNode(Node* node, bool tail) {
+	if (auto* program = dynamic_cast<Program*>(node)) {
+		CompiledNode compiled = compileBlock(program->statements, program, false);
+		compiled.run = runProgram;
+		return compiled;
+	}
+
+	if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(node)) {
+		return compileNode(exprStmt->value.get(), tail);
+	}
+
+	if (auto* blockStmt = dynamic_cast<BlockStatement*>(node)) {
+		return compileBlock(blockStmt->statements, blockStmt, tail);
+	}
+
+	if (auto* letStmt = dynamic_cast<LetStatement*>(node)) {
+		CompiledNode compiled = make(runLet, letStmt);
+		compiled.children.push_back(compileNode(letStmt->value.get(), false));
+		return compiled;
+	}
+
+	if (auto* returnStmt = dynamic_cast<ReturnStatement*>(node)) {
+		CompiledNode compiled = make(runReturn, returnStmt);
+		compiled.children.push_back(compileNode(returnStmt->value.get(), false));
+		return compiled;
+	}
+
+	if (auto* intLit = dynamic_cast<IntegerLiteral*>(node)) {
+		return constant(makeRef<Integer>(intLit->value));
+	}
+
+	if (auto* boolLit = dynamic_cast<BooleanLiteral*>(node)) {
+		return constant(makeRef<Boolean>(boolLit->value));
+	}
+
+	if (auto* stringLit = dynamic_cast<StringLiteral*>(node)) {
+		return make(runString, stringLit);
+	}
+
+	if (auto* ident = dynamic_cast<Identifier*>(node)) {
+		return make(runIdentifier, ident);
+	}
+
+	if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(node)) {
+		CompiledNode compiled = make(runPrefix, prefixExpr);
+		compiled.children.push_back(compileNode(prefixExpr->right.get(), false));
+		return compiled;
+	}
+
+	if (auto* infixExpr = dynamic_cast<InfixExpression*>(node)) {
+		CompiledNode compiled = make(runInfix, infixExpr);
+		compiled.children.push_back(compileNode(infixExpr->left.get(), false));
+		compiled.children.push_back(compileNode(infixExpr->right.get(), false));
+		return compiled;
+	}
+
+	if (auto* ifExpr = dynamic_cast<IfExpression*>(node)) {
+		CompiledNode compiled = make(runIf, ifExpr);
+		compiled.children.push_back(compileNode(ifExpr->condition.get(), false));
+		compiled.children.push_back(compileNode(ifExpr->consequence.get(), tail));
+		if (ifExpr->alternative) {
+			compiled.children.push_back(compileNode(ifExpr->alternative.get(), tail));
+		}
+		return compiled;
+	}
+
+	if (auto* funcLit = dynamic_cast<FunctionLiteral*>(node)) {
+		if (funcLit->body) {
+			compiledBody(funcLit->body.get());
+		}
+		return make(runFunctionLiteral, funcLit);
+	}
+
+	if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
+		CompiledNode compiled = make(tail ? runTailCall : runCall, callExpr);
+		compiled.children.push_back(compileNode(callExpr->function.get(), false));
+		for (const auto& arg : callExpr->arguments) {
+			compiled.children.push_back(compileNode(arg.get(), false));
+		}
+		return compiled;
+	}
+
+	return constant(nullptr);
+}
+
+}
+
+std::shared_ptr<const CompiledNode> compile(Node* node) {
+	return std::make_shared<const CompiledNode>(compileNode(node, false));
+}
+
+ObjectRef evalCompiled(Node* node, EnvironmentRef env) {
+	return (*compile(node))(env);
+}
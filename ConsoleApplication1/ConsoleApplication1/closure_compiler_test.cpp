@@ -0,0 +1,126 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "closure_compiler.hpp"
+#include "test_helpers.hpp"
+
+// ====== TEST FUNCTIONS ======
+
+static void TestCompiledMatchesEval() {
+    std::vector<std::string> inputs = {
+        "5 + 5 * 2 - -3",
+        "(5 + 10 * 2 + 15 / 3) * 2 + -10",
+        "!true == false",
+        "!!5",
+        "if (1 > 2) { 10 }",
+        "if (1 > 2) { 10 } else { 20 }",
+        "9; return 2 * 5; 9;",
+        "if (10 > 1) { if (10 > 1) { return 10; } return 1; }",
+        "5 + true; 5;",
+        "-true",
+        "foobar",
+        "10 / 0",
+        R"("Hello" + " " + "World!")",
+        R"("Hello" - "World")",
+        "let a = 5; let b = a; let c = a + b + 5; c;",
+        "let add = fn(x, y) { x + y; }; add(5 + 5, add(5, 5));",
+        "fn(x) { x; }(5)",
+        "let newAdder = fn(x) { fn(y) { x + y } }; let addTwo = newAdder(2); addTwo(3);",
+        "let f = fn(x) { return x * 2; 100 }; f(4) + 1",
+        "let f = fn() { 5(1) }; f();",
+        "let f = fn(x) { let y = x + 1; y * 2 }; f(3) + f(4)",
+        "let f = fn(x) { if (x) { return 1; } 2 }; f(true) * 10 + f(false)",
+        "let f = fn() { }; f()",
+        "let f = fn(x) { x(1) }; f(fn(y) { y + foo })",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } }; fib(15)",
+        "let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1, acc + 2) } }; loop(100000, 0)",
+        "let countdown = fn(n) { if (n == 0) { return 0; } return countdown(n - 1); }; countdown(100000)",
+        "let f = fn(a, b) { a }; f(1)",
+        "let f = fn(a) { a }; f(1, 2)",
+        "let f = fn(a, b) { b }; f(1)",
+        "let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1) } }; loop(3, 7)",
+    };
+
+    for (const auto& input : inputs) {
+        std::unique_ptr<Program> treeProgram = parse(input);
+        std::unique_ptr<Program> compiledProgram = parse(input);
+
+        std::string expected = describe(eval(treeProgram.get(), makeRef<Environment>()).get());
+        std::string got = describe(evalCompiled(compiledProgram.get(), makeRef<Environment>()).get());
+
+        if (expected != got) {
+            std::cerr << "compiled result differs for \"" << input << "\". expected="
+                      << expected << ", got=" << got << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestCompiledMatchesEval passed!\n";
+}
+
+static void TestCompiledCodeIsReusable() {
+    std::unique_ptr<Program> program = parse("let counter = fn(n) { n * 2 }; counter(21)");
+    std::shared_ptr<const CompiledNode> code = compile(program.get());
+
+    for (int i = 0; i < 3; i++) {
+        ObjectRef result = (*code)(makeRef<Environment>());
+        Integer* value = dynamic_cast<Integer*>(result.get());
+        if (!value || value->value != 42) {
+            std::cerr << "run " << i << " wrong. got=" << describe(result.get()) << "\n";
+            return;
+        }
+    }
+
+    // literals are built at compile time and shared by every run
+    std::unique_ptr<Program> literal = parse("7");
+    std::shared_ptr<const CompiledNode> literalCode = compile(literal.get());
+    auto env = makeRef<Environment>();
+    if ((*literalCode)(env) != (*literalCode)(env)) {
+        std::cerr << "integer literal rebuilt on every run\n";
+        return;
+    }
+
+    std::cout << "TestCompiledCodeIsReusable passed!\n";
+}
+
+static void TestEnginesShareEnvironments() {
+    // a function made by eval, called from compiled code and the other way around
+    auto env = makeRef<Environment>();
+
+    std::unique_ptr<Program> defineTree = parse("let twice = fn(f, x) { f(f(x)) };");
+    eval(defineTree.get(), env);
+
+    std::unique_ptr<Program> defineCompiled = parse("let inc = fn(x) { x + 1 };");
+    evalCompiled(defineCompiled.get(), env);
+
+    std::unique_ptr<Program> compiledCall = parse("twice(inc, 1)");
+    std::unique_ptr<Program> treeCall = parse("twice(inc, 10)");
+
+    ObjectRef compiled = evalCompiled(compiledCall.get(), env);
+    ObjectRef tree = eval(treeCall.get(), env);
+
+    Integer* compiledValue = dynamic_cast<Integer*>(compiled.get());
+    Integer* treeValue = dynamic_cast<Integer*>(tree.get());
+    if (!compiledValue || compiledValue->value != 3 || !treeValue || treeValue->value != 12) {
+        std::cerr << "engines disagree. compiled=" << describe(compiled.get())
+                  << ", tree=" << describe(tree.get()) << "\n";
+        return;
+    }
+
+    std::cout << "TestEnginesShareEnvironments passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestCompiledMatchesEval();
+//    TestCompiledCodeIsReusable();
+//    TestEnginesShareEnvironments();
+//    return 0;
+//}
@@ -0,0 +1,188 @@
+#include <unordered_set>
+#include "closures.hpp"
+#include "gc.hpp"
+
+namespace {
+	// every name a function body binds with a let, leaving out the literals nested in it
+	void collectLets(Node* node, std::unordered_set<Symbol>& lets) {
+		if (!node) {
+			return;
+		}
+
+		if (auto* letStmt = dynamic_cast<LetStatement*>(node)) {
+			lets.insert(letStmt->name->symbol);
+			collectLets(letStmt->value.get(), lets);
+		}
+		else if (auto* blockStmt = dynamic_cast<BlockStatement*>(node)) {
+			for (const auto& stmt : blockStmt->statements) {
+				collectLets(stmt.get(), lets);
+			}
+		}
+		else if (auto* returnStmt = dynamic_cast<ReturnStatement*>(node)) {
+			collectLets(returnStmt->value.get(), lets);
+		}
+		else if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(node)) {
+			collectLets(exprStmt->value.get(), lets);
+		}
+		else if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(node)) {
+			collectLets(prefixExpr->right.get(), lets);
+		}
+		else if (auto* infixExpr = dynamic_cast<InfixExpression*>(node)) {
+			collectLets(infixExpr->left.get(), lets);
+			collectLets(infixExpr->right.get(), lets);
+		}
+		else if (auto* ifExpr = dynamic_cast<IfExpression*>(node)) {
+			collectLets(ifExpr->condition.get(), lets);
+			collectLets(ifExpr->consequence.get(), lets);
+			collectLets(ifExpr->alternative.get(), lets);
+		}
+		else if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
+			collectLets(callExpr->function.get(), lets);
+			for (const auto& arg : callExpr->arguments) {
+				collectLets(arg.get(), lets);
+			}
+			collectLets(callExpr->inlined.get(), lets);
+		}
+	}
+
+	// what a function body refers to before binding it: parameters are bound from the start, a let
+	// from the statement after it, and a let inside an if only when both branches bind the name
+	struct Scope {
+		std::vector<Symbol> uses;
+		std::unordered_set<Symbol> binds; // parameters and every let, for the literals nested in it
+	};
+
+	void analyze(FunctionLiteral* funcLit, const std::unordered_set<Symbol>* enclosing);
+
+	// bound: the names every path to node has bound by the time it is evaluated
+	void collect(Node* node, Scope& scope, std::unordered_set<Symbol>& bound) {
+		if (!node) {
+			return;
+		}
+
+		if (auto* ident = dynamic_cast<Identifier*>(node)) {
+			if (!bound.count(ident->symbol)) {
+				scope.uses.push_back(ident->symbol);
+			}
+		}
+		else if (auto* funcLit = dynamic_cast<FunctionLiteral*>(node)) {
+			// the literal can be called before a let that comes later, so what it captures and
+			// isn't bound yet is read from outside
+			analyze(funcLit, &scope.binds);
+			for (const Capture& capture : funcLit->captures) {
+				if (!bound.count(capture.symbol)) {
+					scope.uses.push_back(capture.symbol);
+				}
+			}
+		}
+		else if (auto* letStmt = dynamic_cast<LetStatement*>(node)) {
+			collect(letStmt->value.get(), scope, bound);
+			bound.insert(letStmt->name->symbol);
+		}
+		else if (auto* blockStmt = dynamic_cast<BlockStatement*>(node)) {
+			for (const auto& stmt : blockStmt->statements) {
+				collect(stmt.get(), scope, bound);
+			}
+		}
+		else if (auto* returnStmt = dynamic_cast<ReturnStatement*>(node)) {
+			collect(returnStmt->value.get(), scope, bound);
+		}
+		else if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(node)) {
+			collect(exprStmt->value.get(), scope, bound);
+		}
+		else if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(node)) {
+			collect(prefixExpr->right.get(), scope, bound);
+		}
+		else if (auto* infixExpr = dynamic_cast<InfixExpression*>(node)) {
+			collect(infixExpr->left.get(), scope, bound);
+			collect(infixExpr->right.get(), scope, bound);
+		}
+		else if (auto* ifExpr = dynamic_cast<IfExpression*>(node)) {
+			collect(ifExpr->condition.get(), scope, bound);
+			std::unordered_set<Symbol> consequence = bound;
+			std::unordered_set<Symbol> alternative = bound;
+			collect(ifExpr->consequence.get(), scope, consequence);
+			collect(ifExpr->alternative.get(), scope, alternative);
+			for (Symbol symbol : consequence) {
+				if (alternative.count(symbol)) {
+					bound.insert(symbol);
+				}
+			}
+		}
+		else if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
+			collect(callExpr->function.get(), scope, bound);
+			for (const auto& arg : callExpr->arguments) {
+				collect(arg.get(), scope, bound);
+			}
+			// an inlined expansion is evaluated in this frame too, and may hold copies of literals;
+			// it stands in for the call, so its lets don't bind anything after it
+			std::unordered_set<Symbol> inlined = bound;
+			collect(callExpr->inlined.get(), scope, inlined);
+		}
+	}
+
+	// enclosing: the names the function funcLit is in binds, nullptr when that isn't known
+	void analyze(FunctionLiteral* funcLit, const std::unordered_set<Symbol>* enclosing) {
+		Scope scope;
+		std::unordered_set<Symbol> bound;
+		for (const auto& param : funcLit->parameters) {
+			scope.binds.insert(param->symbol);
+			bound.insert(param->symbol);
+		}
+		collectLets(funcLit->body.get(), scope.binds);
+		collect(funcLit->body.get(), scope, bound);
+
+		funcLit->captures.clear();
+		std::unordered_set<Symbol> seen;
+		for (Symbol symbol : scope.uses) {
+			if (seen.insert(symbol).second) {
+				funcLit->captures.push_back({ symbol, !enclosing || enclosing->count(symbol) });
+			}
+		}
+		funcLit->capturesKnown = true;
+	}
+}
+
+const std::vector<Capture>& freeVariables(FunctionLiteral* funcLit) {
+	if (!funcLit->capturesKnown) {
+		analyze(funcLit, nullptr);
+	}
+
+	return funcLit->captures;
+}
+
+EnvironmentRef closureEnvironment(FunctionLiteral* funcLit, const EnvironmentRef& env) {
+	const std::vector<Capture>& captures = freeVariables(funcLit);
+
+	EnvironmentRef outermost = env;
+	while (outermost->outer) {
+		outermost = outermost->outer;
+	}
+
+	if (outermost == env) {
+		return env;
+	}
+
+	EnvironmentRef closure;
+	for (const Capture& capture : captures) {
+		// a name env's function binds is its own even before the let, where a read falls back to
+		// the closure's outer environment
+		Environment* owner = capture.local ? env.get() : nullptr;
+		for (Environment* scope = env.get(); !owner && scope != outermost.get(); scope = scope->outer.get()) {
+			if (scope->store.find(capture.symbol)) {
+				owner = scope;
+			}
+		}
+
+		if (!owner) {
+			continue;
+		}
+
+		if (!closure) {
+			closure = newEnclosedEnvironment(env->outer);
+		}
+		closure->setObject(capture.symbol, owner->upvalue(capture.symbol));
+	}
+
+	return closure ? closure : outermost;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "gc.hpp"
+#include "closures.hpp"
+#include "test_helpers.hpp"
+
+// ====== HELPER FUNCTIONS ======
+
+// the function literals of program, in source order
+static std::vector<FunctionLiteral*> functionLiterals(Program* program) {
+    std::vector<FunctionLiteral*> literals;
+    forEachNode(program, [&literals](Node* node) {
+        if (auto* funcLit = dynamic_cast<FunctionLiteral*>(node)) {
+            literals.push_back(funcLit);
+        }
+    });
+    return literals;
+}
+
+static std::string describe(const std::vector<Capture>& captures) {
+    std::string out;
+    for (const Capture& capture : captures) {
+        out += (out.empty() ? "" : " ") + symbolName(capture.symbol) + (capture.local ? "" : "^");
+    }
+    return out;
+}
+
+// ====== TEST FUNCTIONS ======
+
+static void TestFreeVariables() {
+    // each literal's free variables, '^' marking the ones its enclosing function doesn't bind
+    std::vector<std::pair<std::string, std::vector<std::string>>> tests = {
+        {"fn(x) { x * 2 }", {""}},
+        {"fn(a) { let b = a * 10; fn(c) { a + b + c + d } }", {"d", "a b d^"}},
+        {"fn(n) { let loop = fn(k) { if (k < 1) { n } else { loop(k - 1) } }; loop(n) }", {"loop", "n loop"}},
+        {"fn(a) { fn(b) { fn(c) { a + b + c + add(a, c) } } }", {"add", "a add^", "a^ b add^"}},
+        {"fn() { let get = fn() { y }; let y = 2; get() }", {"y", "y"}},
+        // read before the let, or bound on one path only
+        {"fn() { let y = x; let x = 2; y }", {"x"}},
+        {"fn() { if (a > 0) { let a = 100; a } else { a } }", {"a"}},
+        {"fn() { if (a > 0) { let a = 1; a } else { let a = 2; a }; a }", {"a"}},
+        {"fn(b) { if (b) { let a = 1; a } else { let a = 2; a }; a }", {""}},
+    };
+
+    for (const auto& [input, expected] : tests) {
+        std::unique_ptr<Program> program = parse(input);
+        std::vector<FunctionLiteral*> literals = functionLiterals(program.get());
+
+        // the outermost literal is analysed first, as it is always created first
+        for (size_t i = 0; i < literals.size(); i++) {
+            std::string got = describe(freeVariables(literals[i]));
+            if (got != expected[i]) {
+                std::cerr << "wrong free variables of literal " << i << " in " << input
+                          << ". expected=\"" << expected[i] << "\", got=\"" << got << "\"\n";
+                return;
+            }
+        }
+    }
+
+    std::cout << "TestFreeVariables passed!\n";
+}
+
+static void TestUpvaluesKeepScoping() {
+    std::vector<std::pair<std::string, std::string>> tests = {
+        // nested captures, and a frame's names captured two levels down
+        {"let make = fn(a) { fn(b) { fn(c) { a + b + c } } }; make(1)(2)(3)", "INTEGER 6"},
+        // a let after the closure was made is seen by it
+        {"let g = fn() { let x = 1; let get = fn() { x }; let x = 5; get() }; g()", "INTEGER 5"},
+        {"let y = 1; let m = fn() { let get = fn() { y }; let y = 2; get() }; m()", "INTEGER 2"},
+        // recursive and mutually recursive local functions
+        {"let f = fn(n) { let even = fn(k) { if (k == 0) { true } else { odd(k - 1) } }; "
+         "let odd = fn(k) { if (k == 0) { false } else { even(k - 1) } }; even(n) }; f(10)", "BOOLEAN true"},
+        // globals bound after the closure was made
+        {"let h = fn() { fn() { later } }; let k = h(); let later = 9; k()", "INTEGER 9"},
+        // a parameter shadowing a captured name
+        {"let outer = fn(x) { fn(x) { x * 2 } }; outer(1)(21)", "INTEGER 42"},
+        // closures made in a loop capture the values of their own call
+        {"let adders = fn(n, acc) { if (n < 1) { acc } else { adders(n - 1, acc + fn(v) { v + n }(0)) } }; adders(10, 0)", "INTEGER 55"},
+        // a name read before its let, or bound on some paths only, is the one outside
+        {"let g = fn() { let x = 1; let f = fn() { let x = x + 5; x }; f() + x }; g()", "INTEGER 7"},
+        {"let x = 1; let f = fn() { let y = x; let x = 2; y }; f()", "INTEGER 1"},
+        {"let a = 1; let f = fn() { if (a > 0) { let a = 100; a } else { a } }; f() + a", "INTEGER 101"},
+        {"let h = fn() { let x = 1; let f = fn() { let get = fn() { x }; let r = get(); let x = 2; r * 10 + get() }; f() }; h()", "INTEGER 12"},
+        {"let broken = fn() { let get = fn() { missing }; get() }; broken()", "ERROR ERROR : identifier not found: missing"},
+    };
+
+    for (const auto& [input, expected] : tests) {
+        std::string captured = evaluated(input, &GcConfig::capture, true);
+        std::string whole = evaluated(input, &GcConfig::capture, false);
+        if (captured != expected || whole != expected) {
+            std::cerr << "wrong result for " << input << ". expected=" << expected
+                      << ", got=" << captured << " (whole environments: " << whole << ")\n";
+            return;
+        }
+    }
+
+    std::cout << "TestUpvaluesKeepScoping passed!\n";
+}
+
+static void TestClosuresKeepOnlyFreeVariables() {
+    Heap heap;
+    auto env = heap.newEnvironment(nullptr);
+    std::unique_ptr<Program> program = parse(R"(
+        let make = fn(n) {
+            let big = "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx" + "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+            let small = n * 2;
+            fn(x) { x + small }
+        };
+        let f = make(3);
+    )");
+    eval(program.get(), env);
+
+    auto* f = static_cast<Function*>(env->getObject("f").first.get());
+    if (f->env->store.size() != 1 || f->env->getObject("big").second || f->env->outer != env) {
+        std::cerr << "closure kept more than its free variables. bindings=" << f->env->store.size() << "\n";
+        return;
+    }
+
+    std::unique_ptr<Program> call = parse("f(1)");
+    if (describe(eval(call.get(), env).get()) != "INTEGER 7") {
+        std::cerr << "wrong result from the captured upvalue\n";
+        return;
+    }
+
+    // nothing to capture: the closure is enclosed by the global environment directly
+    std::unique_ptr<Program> nested = parse("let wrap = fn() { fn(y) { y + 1 } }; let inc = wrap();");
+    eval(nested.get(), env);
+    if (static_cast<Function*>(env->getObject("inc").first.get())->env != env) {
+        std::cerr << "a closure with no free variables got an environment of its own\n";
+        return;
+    }
+
+    std::cout << "TestClosuresKeepOnlyFreeVariables passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestFreeVariables();
+//    TestUpvaluesKeepScoping();
+//    TestClosuresKeepOnlyFreeVariables();
+//    return 0;
+//}
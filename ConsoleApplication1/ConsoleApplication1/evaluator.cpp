@@ -1,443 +1,825 @@
-#include "evaluator.hpp"
-#include <vector>
-
-static std::unique_ptr<Object> evalProgram(const std::vector<std::unique_ptr<Statement>>& statements, std::shared_ptr<Environment> env);
-static std::unique_ptr<Object> evalPrefixExpression(const std::string& op, std::unique_ptr<Object> right);
-static std::unique_ptr<Object> evalBangOperatorExpression(std::unique_ptr<Object> right);
-static std::unique_ptr<Object> evalMinusPrefixOperatorExpression(std::unique_ptr<Object> right);
-static std::unique_ptr<Object> evalInfixExpression(const std::string& op,
-	std::unique_ptr<Object> left, std::unique_ptr<Object> right);
-static std::unique_ptr<Object> evalIntegerInfixExpression(const std::string& op,
-	Integer* left, Integer* right);
-static std::unique_ptr<Object> evalStringInfixExpression(const std::string& op, String* left, String* right);
-static std::unique_ptr<Object> evalIfExpression(IfExpression* ifExpr, std::shared_ptr<Environment> env);
-static std::unique_ptr<Object> evalBlockStatement(BlockStatement* block, std::shared_ptr<Environment> env);
-static std::unique_ptr<Object> evalIdentifier(Identifier* ident, std::shared_ptr<Environment> env);
-static std::vector<std::unique_ptr<Object>> evalExpressions(const std::vector<std::unique_ptr<Expression>>& exps,
-	std::shared_ptr<Environment> env);
-static std::unique_ptr<Object> applyFunction(Object* fn, std::vector<std::unique_ptr<Object>>& args);
-static std::shared_ptr<Environment> extendFunctionEnv(Function* fn, std::vector<std::unique_ptr<Object>>& args);
-static std::unique_ptr<Object> unwrapReturnValue(std::unique_ptr<Object> obj);
-
-
-bool isTruthy(Object* obj) {
-
-	if (obj == nullptr) {
-		return false;
-	}
-
-	if (dynamic_cast<Null*>(obj)) {
-		return false;
-	}
-
-	if (Boolean* boolObj = dynamic_cast<Boolean*>(obj)) {
-		return boolObj->value;
-	}
-
-	return true;
-}
-
-bool isError(Object* obj) {
-	if (obj) {
-		return obj->Type() == objectTypes::ERROR_OBJ;
-	}
-
-	return false;
-}
-
-
-std::unique_ptr<Object> eval(Node* node, std::shared_ptr<Environment> env) {
-
-	if (auto* progLit = dynamic_cast<Program*>(node))
-		return evalProgram(progLit->statements, env);
-
-	if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(node))
-		return eval(exprStmt->value.get(), env);
-
-	if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(node)) {
-		std::unique_ptr<Object> right = eval(prefixExpr->right.get(), env);
-
-		if (isError(right.get())) {
-			return right;
-		}
-
-		return evalPrefixExpression(prefixExpr->oper, std::move(right));
-	}
-
-	if (auto* infixExpr = dynamic_cast<InfixExpression*>(node)){
-		std::unique_ptr<Object> left = eval(infixExpr->left.get(), env);
-		if (isError(left.get())) {
-			return left;
-		}
-
-		std::unique_ptr<Object> right = eval(infixExpr->right.get(), env);
-		if (isError(right.get())) {
-			return right;
-		}
-
-		return evalInfixExpression(infixExpr->oper, std::move(left), std::move(right));
-	}
-
-	if (auto* ifExpr = dynamic_cast<IfExpression*>(node)) {
-		return evalIfExpression(ifExpr, env);
-	}
-
-	if (auto* blockStmt = dynamic_cast<BlockStatement*>(node)) {
-		return evalBlockStatement(blockStmt, env);
-	}
-
-	if (auto* returnStmt = dynamic_cast<ReturnStatement*>(node)) {
-		std::unique_ptr<Object> val = eval(returnStmt->value.get(), env);
-		if (isError(val.get())) {
-			return val;
-		}
-
-		return std::make_unique<ReturnValue>(std::move(val));
-	}
-
-	if (auto* letStmt = dynamic_cast<LetStatement*>(node)) {
-		std::unique_ptr<Object> val = eval(letStmt->value.get(), env);
-		if (isError(val.get())) {
-			return val;
-		}
-
-		env->setObject(letStmt->name->value, std::shared_ptr<Object>(val.release()));
-		return nullptr;
-	}
-
-	if (auto* funcLit = dynamic_cast<FunctionLiteral*>(node)) {
-		std::unique_ptr<Function> fn = std::make_unique<Function>();
-
-		for (const auto& p : funcLit->parameters)
-			fn->parameters.push_back(p.get());
-
-		fn->body = funcLit->body.get();
-		fn->env = env;
-
-		return fn;
-	}
-
-	if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
-
-		std::unique_ptr<Object> fn = eval(callExpr->function.get(), env);
-
-
-		if (isError(fn.get())) {
-			return fn;
-		}
-
-		std::vector<std::unique_ptr<Object>> args = evalExpressions(callExpr->arguments, env);
-
-		if (args.size() == 1 && isError(args[0].get())) {
-			return std::move(args[0]);
-		}
-
-		return applyFunction(fn.get(), args);
-	}
-
-	if (auto* ident = dynamic_cast<Identifier*>(node)) {
-		return evalIdentifier(ident, env);
-	}
-
-	if (auto* intLit = dynamic_cast<IntegerLiteral*>(node))
-		return std::make_unique<Integer>(intLit->value);
-
-	if (auto* boolLit = dynamic_cast<BooleanLiteral*>(node))
-		return std::make_unique<Boolean>(boolLit->value);
-
-	if (auto* stringLit = dynamic_cast<StringLiteral*>(node))
-		return std::make_unique<String>(stringLit->value);
-
-	return nullptr;
-}
-
-
-
-std::unique_ptr<Object> evalProgram(const std::vector<std::unique_ptr<Statement>>& statements
-	, std::shared_ptr<Environment> env) {
-	std::unique_ptr<Object> result;
-
-	for (const auto& stmt : statements) {
-		result = eval(stmt.get(), env);
-
-		if (result && result->Type() == objectTypes::RETURN_OBJ) {
-			ReturnValue* returnVal = dynamic_cast<ReturnValue*>(result.get());
-			return std::move(returnVal->value);
-		}
-
-		if (result && result->Type() == objectTypes::ERROR_OBJ) {
-			return result;
-		}
-	}
-
-	return result;
-}
-
-
-static std::unique_ptr<Object> evalBlockStatement(BlockStatement* block
-	, std::shared_ptr<Environment> env) {
-	std::unique_ptr<Object> result;
-
-	for (const auto& stmt : block->statements) {
-		result = eval(stmt.get(), env);
-
-		if (result && result->Type() == objectTypes::RETURN_OBJ) {
-			return result;
-		}
-
-		if (result && result->Type() == objectTypes::ERROR_OBJ) {
-			return result;
-		}
-	}
-
-	return result;
-}
-
-static std::unique_ptr<Object> applyFunction(Object* fn, std::vector<std::unique_ptr<Object>>& args) {
-	if (!fn) {
-		return std::make_unique<Error>("not a function: got NULL");
-	}
-
-	Function* function = dynamic_cast<Function*>(fn);
-
-	if (!function) {
-		return std::make_unique<Error>("not a function: " + fn->Type());
-	}
-
-	std::shared_ptr<Environment> extendedEnv = extendFunctionEnv(function, args);
-	std::unique_ptr<Object> evaluated = eval(function->body, extendedEnv);
-	return unwrapReturnValue(std::move(evaluated));
-}
-
-static std::shared_ptr<Environment> extendFunctionEnv(Function* fn, std::vector<std::unique_ptr<Object>>& args) {
-	// Create new enclosed environment with function's captured environment as outer
-	std::shared_ptr<Environment> env = std::make_shared<Environment>(fn->env);
-
-	// Bind each parameter to its corresponding argument
-	for (size_t paramIdx = 0; paramIdx < fn->parameters.size(); paramIdx++) {
-		// Create a copy of the argument to store in the environment
-		Object* arg = args[paramIdx].get();
-		std::shared_ptr<Object> argCopy;
-
-		if (auto* intVal = dynamic_cast<Integer*>(arg)) {
-			argCopy = std::make_shared<Integer>(intVal->value);
-		}
-		else if (auto* boolVal = dynamic_cast<Boolean*>(arg)) {
-			argCopy = std::make_shared<Boolean>(boolVal->value);
-		}
-		else if (auto* strVal = dynamic_cast<String*>(arg)) {
-			argCopy = std::make_shared<String>(strVal->value);
-		}
-		else if (dynamic_cast<Null*>(arg)) {
-			argCopy = std::make_shared<Null>();
-		}
-		else if (auto* funcVal = dynamic_cast<Function*>(arg)) {
-			// For functions, we can share the pointer since they capture their environment
-			argCopy = std::shared_ptr<Object>(args[paramIdx].get(), [](Object*) {});
-		}
-		else {
-			// For other types, try to share safely
-			argCopy = std::shared_ptr<Object>(args[paramIdx].get(), [](Object*) {});
-		}
-
-		env->setObject(fn->parameters[paramIdx]->value, argCopy);
-	}
-
-	return env;
-}
-
-static std::unique_ptr<Object> unwrapReturnValue(std::unique_ptr<Object> obj) {
-	if (ReturnValue* returnValue = dynamic_cast<ReturnValue*>(obj.get())) {
-		return std::move(returnValue->value);
-	}
-	return obj;
-}
-
-std::unique_ptr<Object> evalPrefixExpression(const std::string& op, std::unique_ptr<Object> right) {
-	if (op == "!") {
-		return evalBangOperatorExpression(std::move(right));
-	}
-	else if (op == "-") {
-		return evalMinusPrefixOperatorExpression(std::move(right));
-	}
-	else {
-		return std::make_unique<Error>("Unknown operator : " + op + "; object type : " + right->Type());
-	}
-}
-
-static std::unique_ptr<Object> evalBangOperatorExpression(std::unique_ptr<Object> right) {
-	if (auto* boolObj = dynamic_cast<Boolean*>(right.get())) {
-		return std::make_unique<Boolean>(!boolObj->value);
-	}
-
-	if (dynamic_cast<Null*>(right.get())) {
-		return std::make_unique<Boolean>(true);
-	}
-
-	return std::make_unique<Boolean>(false);
-}
-
-static std::unique_ptr<Object> evalMinusPrefixOperatorExpression(std::unique_ptr<Object> right) {
-	if (auto* intType = dynamic_cast<Integer*>(right.get())) {
-		int64_t val = -intType->value;
-		return std::make_unique<Integer>(val);
-	}
-	else {
-		return std::make_unique<Error>("Type missmatch : " + right->Type());
-	}
-}
-
-static std::unique_ptr<Object> evalInfixExpression(const std::string & op, std::unique_ptr<Object> left, 
-	std::unique_ptr<Object> right) {
-	auto* leftExpr = dynamic_cast<Integer*>(left.get());
-	auto* rightExpr = dynamic_cast<Integer*>(right.get());
-	if ( leftExpr && rightExpr){
-		return evalIntegerInfixExpression(op, leftExpr, rightExpr);
-	}
-
-	auto* leftStr = dynamic_cast<String*>(left.get());
-	auto* rightStr = dynamic_cast<String*>(right.get());
-	if (leftStr && rightStr) {
-		return evalStringInfixExpression(op, leftStr, rightStr);
-	}
-
-	if (op == "==") {
-		auto* leftBool = dynamic_cast<Boolean*>(left.get());
-		auto* rightBool = dynamic_cast<Boolean*>(right.get());
-
-		if (leftBool && rightBool) {
-			return std::make_unique<Boolean>(leftBool->value == rightBool->value);
-		}
-	}
-	if (op == "!=") {
-		auto* leftBool = dynamic_cast<Boolean*>(left.get());
-		auto* rightBool = dynamic_cast<Boolean*>(right.get());
-
-		if (leftBool && rightBool) {
-			return std::make_unique<Boolean>(leftBool->value != rightBool->value);
-		}
-	}
-
-	if (left->Type() != right->Type()) {
-		return std::make_unique<Error>("type mismatch: " + left->Type() + " + " + right->Type());
-	}
-
-	return std::make_unique<Error>("unknown operator : " + op + "; object types: " + left->Type() + right->Type());
-
-}
-
-static std::unique_ptr<Object> evalIntegerInfixExpression(const std::string& op,
-	Integer* left, Integer* right) {
-	int64_t left_val = left->value, right_val = right->value;
-
-	if (op == "+") {
-		return std::make_unique<Integer>(left_val + right_val);
-	}
-	else if (op == "-") {
-		return std::make_unique<Integer>(left_val - right_val);
-	}
-	else if (op == "*") {
-		return std::make_unique<Integer>(left_val * right_val);
-	}
-	else if (op == "/") {
-		if (right_val == 0) {
-			return std::make_unique<Error>("Division by zero");
-		}
-
-		return std::make_unique<Integer>(left_val / right_val);
-	}
-	else if (op == "<") {
-		return std::make_unique<Boolean>(left_val < right_val);
-	}
-	else if (op == ">") {
-		return std::make_unique<Boolean>(left_val > right_val);
-	}
-	else if (op == "==") {
-		return std::make_unique<Boolean>(left_val == right_val);
-	}
-	else if (op == "!=") {
-		return std::make_unique<Boolean>(left_val != right_val);
-	}
-	else {
-		return std::make_unique<Error>("Unknown operator : " + op);
-	}
-}
-
-static std::unique_ptr<Object> evalStringInfixExpression(const std::string& op, String* left, String* right) {
-
-	if (op == "+") {
-		return std::make_unique<String>(left->value + right->value);
-	}
-
-	return std::make_unique<Error>("unknown operator: STRING " + op + " STRING");
-
-}
-
-static std::unique_ptr<Object> evalIfExpression(IfExpression* ifExpr, std::shared_ptr<Environment> env) {
-	std::unique_ptr<Object> condition = eval(ifExpr->condition.get(), env);
-	if (isError(condition.get())) {
-		return condition;
-	}
-
-
-	if (isTruthy(condition.get())) {
-		return eval(ifExpr->consequence.get(), env);
-	}
-	else if (ifExpr->alternative != nullptr){
-		return eval(ifExpr->alternative.get(), env);
-	}
-	else {
-		return nullptr;
-	}
-}
-
-static std::vector<std::unique_ptr<Object>> evalExpressions(const std::vector<std::unique_ptr<Expression>>& exps,
-	std::shared_ptr<Environment> env) {
-	std::vector<std::unique_ptr<Object>> result;
-
-	for (const auto& e : exps) {
-		std::unique_ptr<Object> evaluated = eval(e.get(), env);
-
-		if (isError(evaluated.get())) {
-			std::vector<std::unique_ptr<Object>> errorResult;
-			errorResult.push_back(std::move(evaluated));
-			return errorResult;
-		}
-
-		result.push_back(std::move(evaluated));
-	}
-	return result;
-}
-
-static std::unique_ptr<Object> evalIdentifier(Identifier* ident, std::shared_ptr<Environment> env) {
-
-	auto [obj, found] = env->getObject(ident->value);
-
-	if (!found) {
-		return std::make_unique<Error>("identifier not found: " + ident->value);
-	}
-
-	if (auto* intVal = dynamic_cast<Integer*>(obj.get())) {
-		return std::make_unique<Integer>(intVal->value);
-	}
-	if (auto* boolVal = dynamic_cast<Boolean*>(obj.get())) {
-		return std::make_unique<Boolean>(boolVal->value);
-	}
-	if (auto* stringVal = dynamic_cast<String*>(obj.get())) {
-		return std::make_unique<String>(stringVal->value);
-	}
-	if (dynamic_cast<Null*>(obj.get())) {
-		return std::make_unique<Null>();
-	}
-	if (auto* funcVal = dynamic_cast<Function*>(obj.get())) {
-		auto fn = std::make_unique<Function>();
-		fn->parameters = funcVal->parameters;
-		fn->body = funcVal->body;
-		fn->env = funcVal->env;
-		return fn;
-	}
-
-	return std::make_unique<Error>("unknown object type: " + obj->Type());
-
-}
-
+#include "evaluator.hpp"
+#include "closures.hpp"
+#include "frames.hpp"
+#include "gc.hpp"
+#include "inline_cache.hpp"
+#include "jit.hpp"
+#include "memoizer.hpp"
+#include "specializer.hpp"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+// @brief how evaluating a node ended: with its value, with a return unwinding to the enclosing
+// function, with a call in tail position handed back to it, or with an error unwinding to the
+// top. The status travels next to the value, so none of these needs an object of its own or a
+// look at the value's type
+enum class CompletionType : uint8_t { Normal, Return, TailCall, Error };
+
+struct Completion {
+	ObjectRef value;             // for a TailCall, the callee; its arguments are on the value stack
+	CompletionType type = CompletionType::Normal;
+	CallExpression* site = nullptr; // the call a TailCall makes
+};
+
+// @brief arguments of the calls being made, pushed by the caller and popped by applyFunction
+// once they are bound, so making a call allocates no argument vector. A call's arguments are
+// the top of the stack from the size it had before they were evaluated. Each interpreter has its
+// own on its heap; environments without a heap share one per thread
+static std::vector<ObjectRef>& valueStackOf(Heap* heap) {
+	if (heap) {
+		return heap->valueStack();
+	}
+
+	static thread_local std::vector<ObjectRef> unowned;
+	return unowned;
+}
+
+// @brief the settings of the interpreter owning heap: which tiers its calls may take, and how
+static const GcConfig& configOf(Heap* heap) {
+	if (heap) {
+		return heap->config;
+	}
+
+	static const GcConfig defaults;
+	return defaults;
+}
+
+static Completion evalNode(Node* node, const EnvironmentRef& env);
+static Completion evalOperand(Expression* expr, const EnvironmentRef& env);
+static Completion evalProgram(const std::vector<std::unique_ptr<Statement>>& statements, const EnvironmentRef& env);
+static ObjectRef evalBangOperatorExpression(ObjectRef right, Heap* heap);
+static ObjectRef evalMinusPrefixOperatorExpression(ObjectRef right, Heap* heap);
+static Completion evalIfExpression(IfExpression* ifExpr, const EnvironmentRef& env, bool tail = false);
+static Completion evalBlockStatement(BlockStatement* block, const EnvironmentRef& env, bool tail = false);
+static Completion evalTailStatement(Statement* stmt, const EnvironmentRef& env, bool last);
+static Completion evalTailExpression(Expression* expr, const EnvironmentRef& env);
+static ObjectRef pushExpressions(const std::vector<std::unique_ptr<Expression>>& exps,
+	const EnvironmentRef& env);
+static ObjectRef applyFunction(ObjectRef fn, Heap* heap, size_t base, CallExpression* site);
+static ObjectRef evalTyped(Expression* expr, const EnvironmentRef& env);
+static bool evalInlinedCall(CallExpression* callExpr, const EnvironmentRef& env, Completion& result);
+static void bindParameters(Environment& env, Function* fn, Arguments args);
+static void bindCachedParameters(Environment& env, Function* fn, Arguments args);
+
+
+bool isTruthy(Object* obj) {
+
+	if (obj == nullptr) {
+		return false;
+	}
+
+	switch (obj->kind()) {
+	case ObjectKind::Null:
+		return false;
+	case ObjectKind::Boolean:
+		return static_cast<Boolean*>(obj)->value;
+	default:
+		return true;
+	}
+}
+
+bool isError(Object* obj) {
+	return obj && obj->kind() == ObjectKind::Error;
+}
+
+// the completion of a helper that returns either a value or an Error
+static Completion completed(ObjectRef value) {
+	CompletionType type = isError(value.get()) ? CompletionType::Error : CompletionType::Normal;
+	return { std::move(value), type };
+}
+
+// evaluations ending other than normally are handed to the caller of eval as they always were:
+// the error itself, or the returned value wrapped in a ReturnValue
+ObjectRef eval(Node* node, EnvironmentRef env) {
+	Completion result = evalNode(node, env);
+
+	if (result.type == CompletionType::Return) {
+		return newObject<ReturnValue>(env->heap, std::move(result.value));
+	}
+
+	return std::move(result.value);
+}
+
+static Completion evalNode(Node* node, const EnvironmentRef& env) {
+
+	if (auto* progLit = dynamic_cast<Program*>(node))
+		return evalProgram(progLit->statements, env);
+
+	if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(node))
+		return evalNode(exprStmt->value.get(), env);
+
+	if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(node)) {
+		if (prefixExpr->staticType == StaticType::Integer || prefixExpr->staticType == StaticType::Boolean) {
+			return { evalTyped(prefixExpr, env) };
+		}
+
+		Completion right = evalOperand(prefixExpr->right.get(), env);
+
+		if (right.type == CompletionType::Error) {
+			return right;
+		}
+
+		return completed(evalPrefixExpression(prefixExpr->op, std::move(right.value), env->heap));
+	}
+
+	if (auto* infixExpr = dynamic_cast<InfixExpression*>(node)){
+		if (infixExpr->staticType == StaticType::Integer || infixExpr->staticType == StaticType::Boolean) {
+			return { evalTyped(infixExpr, env) };
+		}
+
+		Completion left = evalOperand(infixExpr->left.get(), env);
+		InfixSpecialization& spec = infixExpr->specialization;
+
+		// operands passing a specialized node's guard are of non-error kinds, so the checks are skipped
+		if (spec.state == InfixSpecialization::State::Specialized && left.value && left.value->kind() == spec.left) {
+			Completion right = evalOperand(infixExpr->right.get(), env);
+			if (right.value && right.value->kind() == spec.right) {
+				return completed(spec.kernel(infixExpr->op, left.value.get(), right.value.get(), env->heap));
+			}
+
+			if (right.type == CompletionType::Error) {
+				return right;
+			}
+
+			return completed(evalInfixNode(infixExpr, std::move(left.value), std::move(right.value), env->heap));
+		}
+
+		if (left.type == CompletionType::Error) {
+			return left;
+		}
+
+		Completion right = evalOperand(infixExpr->right.get(), env);
+		if (right.type == CompletionType::Error) {
+			return right;
+		}
+
+		return completed(evalInfixNode(infixExpr, std::move(left.value), std::move(right.value), env->heap));
+	}
+
+	if (auto* ifExpr = dynamic_cast<IfExpression*>(node)) {
+		return evalIfExpression(ifExpr, env);
+	}
+
+	if (auto* blockStmt = dynamic_cast<BlockStatement*>(node)) {
+		return evalBlockStatement(blockStmt, env);
+	}
+
+	if (auto* returnStmt = dynamic_cast<ReturnStatement*>(node)) {
+		Completion val = evalOperand(returnStmt->value.get(), env);
+		if (val.type == CompletionType::Error) {
+			return val;
+		}
+
+		return { std::move(val.value), CompletionType::Return };
+	}
+
+	if (auto* letStmt = dynamic_cast<LetStatement*>(node)) {
+		Completion val = evalOperand(letStmt->value.get(), env);
+		if (val.type == CompletionType::Error) {
+			return val;
+		}
+
+		env->setObject(letStmt->name->symbol, std::move(val.value));
+		return {};
+	}
+
+	if (auto* funcLit = dynamic_cast<FunctionLiteral*>(node)) {
+		return { evalFunctionLiteral(funcLit, env) };
+	}
+
+	if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
+
+		Completion inlined;
+		if (callExpr->inlined && evalInlinedCall(callExpr, env, inlined)) {
+			return inlined;
+		}
+
+		Completion fn = evalOperand(callExpr->function.get(), env);
+
+
+		if (fn.type == CompletionType::Error) {
+			return fn;
+		}
+
+		std::vector<ObjectRef>& valueStack = valueStackOf(env->heap);
+		size_t base = valueStack.size();
+		if (ObjectRef error = pushExpressions(callExpr->arguments, env)) {
+			return { std::move(error), CompletionType::Error };
+		}
+
+		return completed(applyFunction(std::move(fn.value), env->heap, base, callExpr));
+	}
+
+	if (auto* ident = dynamic_cast<Identifier*>(node)) {
+		return completed(evalIdentifier(ident, env));
+	}
+
+	if (auto* intLit = dynamic_cast<IntegerLiteral*>(node))
+		return { newObject<Integer>(env->heap, intLit->value) };
+
+	if (auto* boolLit = dynamic_cast<BooleanLiteral*>(node))
+		return { newObject<Boolean>(env->heap, boolLit->value) };
+
+	if (auto* stringLit = dynamic_cast<StringLiteral*>(node))
+		return { newString(env->heap, stringLit->value) };
+
+	return {};
+}
+
+// an expression whose value is used: an operand, an argument, a callee, or a value to bind or return.
+// An if that returned from inside a branch hands on its value as a ReturnValue there
+static Completion evalOperand(Expression* expr, const EnvironmentRef& env) {
+	Completion result = evalNode(expr, env);
+
+	if (result.type == CompletionType::Return) {
+		return { newObject<ReturnValue>(env->heap, std::move(result.value)) };
+	}
+
+	return result;
+}
+
+// a statement's value that is a ReturnValue (one bound from such an if, say) returns when it completes
+// the statement
+static Completion completeStatement(Completion result) {
+	if (result.type == CompletionType::Normal && result.value && result.value->kind() == ObjectKind::ReturnValue) {
+		return { std::move(static_cast<ReturnValue*>(result.value.get())->value), CompletionType::Return };
+	}
+
+	return result;
+}
+
+
+
+static Completion evalProgram(const std::vector<std::unique_ptr<Statement>>& statements
+	, const EnvironmentRef& env) {
+	Completion result;
+
+	for (const auto& stmt : statements) {
+		result = completeStatement(evalNode(stmt.get(), env));
+
+		if (result.type == CompletionType::Return) {
+			return { std::move(result.value) };
+		}
+
+		if (result.type == CompletionType::Error) {
+			return result;
+		}
+	}
+
+	return result;
+}
+
+
+// tail = the block is a function body, or a branch of an if in tail position of one
+static Completion evalBlockStatement(BlockStatement* block
+	, const EnvironmentRef& env, bool tail) {
+	Completion result;
+
+	for (size_t i = 0; i < block->statements.size(); i++) {
+		Statement* stmt = block->statements[i].get();
+
+		if (tail) {
+			result = evalTailStatement(stmt, env, i + 1 == block->statements.size());
+		}
+		else {
+			result = evalNode(stmt, env);
+		}
+
+		result = completeStatement(std::move(result));
+		if (result.type != CompletionType::Normal) {
+			return result;
+		}
+	}
+
+	return result;
+}
+
+// drops the value stack back to base
+static void popValues(std::vector<ObjectRef>& valueStack, size_t base) {
+	valueStack.erase(valueStack.begin() + base, valueStack.end());
+}
+
+// calls fn with the arguments on the value stack of the caller's heap from base, and pops them. Calls
+// in tail position push theirs on the same stack: a function's environments all belong to the heap of
+// the one it was made in
+static ObjectRef applyFunction(ObjectRef fn, Heap* heap, size_t base, CallExpression* site) {
+	std::vector<ObjectRef>& valueStack = valueStackOf(heap);
+
+	// the first call below that can be memoized; the loop's result is its result too
+	MemoizedCall memoized;
+
+	// calls in tail position come back as a TailCall, with their arguments pushed from base
+	// again, and are made by this loop, so tail-recursive functions run in constant native stack
+	while (true) {
+		Arguments args(valueStack.data() + base, valueStack.size() - base);
+
+		if (!fn) {
+			popValues(valueStack, base);
+			return newObject<Error>(heap, ErrorCode::NotAFunction, Operator::Unknown, ObjectKind::Count, ObjectKind::Count);
+		}
+
+		Function* function = resolveCallee(site, fn.get());
+
+		if (!function) {
+			popValues(valueStack, base);
+			return newObject<Error>(heap, ErrorCode::NotAFunction, Operator::Unknown, fn->kind(), ObjectKind::Count);
+		}
+
+		// every call takes a frame, so a runaway recursion stops at the memory limit
+		if (!callFits(function)) {
+			popValues(valueStack, base);
+			return newObject<Error>(heap, ErrorCode::MemoryLimitExceeded);
+		}
+
+		const GcConfig& config = configOf(function->env ? function->env->heap : nullptr);
+
+		if (config.memo.enabled && !memoized.function) {
+			memoized = memoizedCall(fn, args);
+			if (memoized.function) {
+				if (ObjectRef cached = memoLookup(memoized)) {
+					popValues(valueStack, base);
+					return cached;
+				}
+			}
+		}
+
+		if (config.jit.enabled) {
+			ObjectRef native = jitCall(function, args, config.jit);
+			if (native) {
+				popValues(valueStack, base);
+				if (memoized.function) {
+					memoStore(memoized, native, config.memo);
+				}
+				return native;
+			}
+		}
+
+		BlockStatement* body = function->body;
+		const Specialization* residual = config.specializer.enabled ? specialize(function, site, config.specializer) : nullptr;
+		if (residual) {
+			body = residual->body;
+		}
+
+		// a frame no closure can keep goes on the frame stack, and is popped as the call returns.
+		// Closures that capture upvalues keep no frame at all
+		bool stacked = config.frames.enabled && (config.capture.enabled || !frameEscapes(body));
+		EnvironmentRef extendedEnv = stacked ? newStackFrame(function->env) : newEnclosedEnvironment(function->env);
+		if (residual) {
+			residual->bindArguments(*extendedEnv, args);
+		}
+		else if (site && site->cache.directBind && args.size() == site->cache.arity) {
+			bindCachedParameters(*extendedEnv, function, args);
+		}
+		else {
+			bindParameters(*extendedEnv, function, args);
+		}
+		popValues(valueStack, base);
+
+		Completion evaluated = evalBlockStatement(body, extendedEnv, true);
+
+		// a heap frame goes back to the heap's pool unless a closure or an enclosed frame kept it;
+		// either kind is gone before a tail call makes the next one
+		if (stacked) {
+			extendedEnv.reset();
+		}
+		else if (Heap* heap = extendedEnv->heap) {
+			heap->recycle(std::move(extendedEnv));
+		}
+
+		if (evaluated.type == CompletionType::TailCall) {
+			fn = std::move(evaluated.value);
+			site = evaluated.site;
+			continue;
+		}
+
+		if (memoized.function) {
+			memoStore(memoized, evaluated.value, config.memo);
+		}
+		return std::move(evaluated.value);
+	}
+}
+
+// 'return <expr>' anywhere in a function body and the value of its last statement are tail positions
+static Completion evalTailStatement(Statement* stmt, const EnvironmentRef& env, bool last) {
+	if (auto* returnStmt = dynamic_cast<ReturnStatement*>(stmt)) {
+		Completion val = evalTailExpression(returnStmt->value.get(), env);
+		if (val.type == CompletionType::Error || val.type == CompletionType::TailCall) {
+			return val;
+		}
+
+		// an if returning from a branch in tail position of the return returns its own value
+		return { std::move(val.value), CompletionType::Return };
+	}
+
+	if (last) {
+		if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(stmt)) {
+			return evalTailExpression(exprStmt->value.get(), env);
+		}
+	}
+
+	return evalNode(stmt, env);
+}
+
+// the value of a call FunctionInlining expanded, in result; false when the callee is no longer the helper
+// it was expanded from (rebound, or shadowed by a parameter) and the call has to be made
+static bool evalInlinedCall(CallExpression* callExpr, const EnvironmentRef& env, Completion& result) {
+	const ObjectRef* callee = lookupIdentifier(static_cast<Identifier*>(callExpr->function.get()), env.get());
+	if (!callee || !*callee || (*callee)->kind() != ObjectKind::Function
+		|| !static_cast<Function*>(callee->get())->code
+		|| static_cast<Function*>(callee->get())->code->serial != callExpr->inlinedFrom) {
+		return false;
+	}
+
+	result = evalNode(callExpr->inlined.get(), env);
+	return true;
+}
+
+// a call in tail position is evaluated up to its callee and arguments, which are left on the value
+// stack, and handed back to applyFunction
+static Completion evalTailExpression(Expression* expr, const EnvironmentRef& env) {
+	if (auto* callExpr = dynamic_cast<CallExpression*>(expr)) {
+		Completion inlined;
+		if (callExpr->inlined && evalInlinedCall(callExpr, env, inlined)) {
+			return inlined;
+		}
+
+		Completion fn = evalOperand(callExpr->function.get(), env);
+		if (fn.type == CompletionType::Error) {
+			return fn;
+		}
+
+		if (ObjectRef error = pushExpressions(callExpr->arguments, env)) {
+			return { std::move(error), CompletionType::Error };
+		}
+
+		return { std::move(fn.value), CompletionType::TailCall, callExpr };
+	}
+
+	if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+		return evalIfExpression(ifExpr, env, true);
+	}
+
+	return evalNode(expr, env);
+}
+
+static void bindParameters(Environment& env, Function* fn, Arguments args) {
+	// Bind each parameter to its corresponding argument; values are immutable, so the
+	// argument handle is shared with the caller instead of being copied. Parameters a call
+	// passes no argument for stay unbound, and arguments past the last parameter are dropped
+	size_t bound = std::min(fn->parameters.size(), args.size());
+	for (size_t paramIdx = 0; paramIdx < bound; paramIdx++) {
+		env.setObject(fn->parameters[paramIdx]->symbol, args[paramIdx]);
+	}
+}
+
+// the parameters of a call whose site cache has checked that they are distinct and fit in the new
+// frame's inline bindings: each is appended without looking for an earlier binding of it. The
+// frame binds nothing yet and isn't captured, so there is nothing to promote or write through
+static void bindCachedParameters(Environment& env, Function* fn, Arguments args) {
+	for (size_t paramIdx = 0; paramIdx < args.size(); paramIdx++) {
+		Symbol symbol = fn->parameters[paramIdx]->symbol;
+		env.store.append(symbol, args[paramIdx]);
+		env.nameMask |= symbolBit(symbol);
+	}
+}
+
+EnvironmentRef extendFunctionEnv(Function* fn, Arguments args) {
+	// Create new enclosed environment with function's captured environment as outer
+	EnvironmentRef env = newEnclosedEnvironment(fn->env);
+	bindParameters(*env, fn, args);
+
+	return env;
+}
+
+ObjectRef unwrapReturnValue(ObjectRef obj) {
+	if (obj && obj->kind() == ObjectKind::ReturnValue) {
+		return std::move(static_cast<ReturnValue*>(obj.get())->value);
+	}
+	return obj;
+}
+
+ObjectRef evalPrefixExpression(Operator op, ObjectRef right, Heap* heap) {
+	switch (op) {
+	case Operator::Bang:
+		return evalBangOperatorExpression(std::move(right), heap);
+	case Operator::Minus:
+		return evalMinusPrefixOperatorExpression(std::move(right), heap);
+	default:
+		return newObject<Error>(heap, ErrorCode::UnknownPrefixOperator, op, ObjectKind::Count, kindOf(right.get()));
+	}
+}
+
+static ObjectRef evalBangOperatorExpression(ObjectRef right, Heap* heap) {
+	switch (kindOf(right.get())) {
+	case ObjectKind::Boolean:
+		return newObject<Boolean>(heap, !static_cast<Boolean*>(right.get())->value);
+	case ObjectKind::Null:
+		return newObject<Boolean>(heap, true);
+	default:
+		return newObject<Boolean>(heap, false);
+	}
+}
+
+static ObjectRef evalMinusPrefixOperatorExpression(ObjectRef right, Heap* heap) {
+	if (kindOf(right.get()) == ObjectKind::Integer) {
+		int64_t val = wrappingNegate(static_cast<Integer*>(right.get())->value);
+		return newObject<Integer>(heap, val);
+	}
+	else {
+		return newObject<Error>(heap, ErrorCode::PrefixTypeMismatch, Operator::Minus, ObjectKind::Count, kindOf(right.get()));
+	}
+}
+
+// @brief one (operator, left kind, right kind) cell of the infix dispatch table. The table
+// only hands a kernel operands of its own kinds, so kernels cast statically
+using InfixKernel = InfixSpecialization::Kernel;
+
+template <int64_t (*Op)(int64_t, int64_t)>
+static ObjectRef integerArithmetic(Operator, Object* left, Object* right, Heap* heap) {
+	return newObject<Integer>(heap, Op(static_cast<Integer*>(left)->value, static_cast<Integer*>(right)->value));
+}
+
+template <typename Op>
+static ObjectRef integerComparison(Operator, Object* left, Object* right, Heap* heap) {
+	return newObject<Boolean>(heap, Op()(static_cast<Integer*>(left)->value, static_cast<Integer*>(right)->value));
+}
+
+static ObjectRef integerDivision(Operator, Object* left, Object* right, Heap* heap) {
+	int64_t divisor = static_cast<Integer*>(right)->value;
+	if (divisor == 0) {
+		return newObject<Error>(heap, ErrorCode::DivisionByZero);
+	}
+
+	return newObject<Integer>(heap, wrappingDivide(static_cast<Integer*>(left)->value, divisor));
+}
+
+template <typename Op>
+static ObjectRef booleanComparison(Operator, Object* left, Object* right, Heap* heap) {
+	return newObject<Boolean>(heap, Op()(static_cast<Boolean*>(left)->value, static_cast<Boolean*>(right)->value));
+}
+
+static ObjectRef stringConcatenation(Operator, Object* left, Object* right, Heap* heap) {
+	const std::string& leftValue = static_cast<String*>(left)->value;
+	const std::string& rightValue = static_cast<String*>(right)->value;
+
+	// checked before the characters are copied, so a runaway concatenation stops at the limit
+	if (heap && !heap->quota().fits(sizeof(String) + leftValue.size() + rightValue.size())) {
+		return newObject<Error>(heap, ErrorCode::MemoryLimitExceeded);
+	}
+
+	return newString(heap, leftValue + rightValue);
+}
+
+static ObjectRef unknownIntegerOperator(Operator op, Object*, Object*, Heap* heap) {
+	return newObject<Error>(heap, ErrorCode::UnknownIntegerOperator, op, ObjectKind::Integer, ObjectKind::Integer);
+}
+
+static ObjectRef unknownStringOperator(Operator op, Object*, Object*, Heap* heap) {
+	return newObject<Error>(heap, ErrorCode::UnknownStringOperator, op, ObjectKind::String, ObjectKind::String);
+}
+
+static ObjectRef mismatchedOperands(Operator op, Object* left, Object* right, Heap* heap) {
+	return newObject<Error>(heap, ErrorCode::OperandMismatch, op, kindOf(left), kindOf(right));
+}
+
+constexpr size_t operatorCount = static_cast<size_t>(Operator::Count);
+constexpr size_t kindCount = static_cast<size_t>(ObjectKind::Count);
+
+struct InfixTable {
+	InfixKernel kernels[operatorCount][kindCount][kindCount];
+	bool specialized[operatorCount][kindCount][kindCount] = {}; // a real kernel, not an error fallback
+
+	void set(Operator op, ObjectKind left, ObjectKind right, InfixKernel kernel) {
+		kernels[static_cast<size_t>(op)][static_cast<size_t>(left)][static_cast<size_t>(right)] = kernel;
+	}
+
+	void specialize(Operator op, ObjectKind left, ObjectKind right, InfixKernel kernel) {
+		set(op, left, right, kernel);
+		specialized[static_cast<size_t>(op)][static_cast<size_t>(left)][static_cast<size_t>(right)] = true;
+	}
+};
+
+static InfixTable buildInfixTable() {
+	InfixTable table;
+
+	for (size_t op = 0; op < operatorCount; op++) {
+		for (size_t left = 0; left < kindCount; left++) {
+			for (size_t right = 0; right < kindCount; right++) {
+				table.kernels[op][left][right] = mismatchedOperands;
+			}
+		}
+
+		table.set(Operator(op), ObjectKind::Integer, ObjectKind::Integer, unknownIntegerOperator);
+		table.set(Operator(op), ObjectKind::String, ObjectKind::String, unknownStringOperator);
+	}
+
+	const ObjectKind I = ObjectKind::Integer, B = ObjectKind::Boolean, S = ObjectKind::String;
+
+	table.specialize(Operator::Plus, I, I, integerArithmetic<wrappingAdd>);
+	table.specialize(Operator::Minus, I, I, integerArithmetic<wrappingSubtract>);
+	table.specialize(Operator::Asterisk, I, I, integerArithmetic<wrappingMultiply>);
+	table.specialize(Operator::Slash, I, I, integerDivision);
+	table.specialize(Operator::Lt, I, I, integerComparison<std::less<int64_t>>);
+	table.specialize(Operator::Gt, I, I, integerComparison<std::greater<int64_t>>);
+	table.specialize(Operator::Eq, I, I, integerComparison<std::equal_to<int64_t>>);
+	table.specialize(Operator::NotEq, I, I, integerComparison<std::not_equal_to<int64_t>>);
+
+	table.specialize(Operator::Eq, B, B, booleanComparison<std::equal_to<bool>>);
+	table.specialize(Operator::NotEq, B, B, booleanComparison<std::not_equal_to<bool>>);
+
+	table.specialize(Operator::Plus, S, S, stringConcatenation);
+
+	return table;
+}
+
+static const InfixTable infixTable = buildInfixTable();
+
+ObjectRef evalInfixExpression(Operator op, ObjectRef left, ObjectRef right, Heap* heap) {
+	if (!left || !right) {
+		return mismatchedOperands(op, left.get(), right.get(), heap);
+	}
+
+	InfixKernel kernel = infixTable.kernels[static_cast<size_t>(op)]
+		[static_cast<size_t>(left->kind())][static_cast<size_t>(right->kind())];
+
+	return kernel(op, left.get(), right.get(), heap);
+}
+
+ObjectRef evalInfixNode(InfixExpression* infixExpr, ObjectRef left, ObjectRef right, Heap* heap) {
+	InfixSpecialization& spec = infixExpr->specialization;
+
+	if (!left || !right) {
+		if (spec.state == InfixSpecialization::State::Specialized) {
+			spec.state = InfixSpecialization::State::Generic;
+		}
+		return evalInfixExpression(infixExpr->op, std::move(left), std::move(right), heap);
+	}
+
+	ObjectKind leftKind = left->kind(), rightKind = right->kind();
+
+	switch (spec.state) {
+	case InfixSpecialization::State::Specialized:
+		if (leftKind == spec.left && rightKind == spec.right) {
+			return spec.kernel(infixExpr->op, left.get(), right.get(), heap);
+		}
+
+		spec.state = InfixSpecialization::State::Generic;
+		break;
+
+	case InfixSpecialization::State::Uninitialized: {
+		if (spec.executions == 0 || leftKind != spec.left || rightKind != spec.right) {
+			spec.left = leftKind;
+			spec.right = rightKind;
+			spec.executions = 0;
+		}
+
+		size_t op = static_cast<size_t>(infixExpr->op);
+		size_t l = static_cast<size_t>(leftKind), r = static_cast<size_t>(rightKind);
+		if (++spec.executions >= InfixSpecialization::specializeAfter && infixTable.specialized[op][l][r]) {
+			spec.state = InfixSpecialization::State::Specialized;
+			spec.kernel = infixTable.kernels[op][l][r];
+		}
+		break;
+	}
+
+	case InfixSpecialization::State::Generic:
+		break;
+	}
+
+	return evalInfixExpression(infixExpr->op, std::move(left), std::move(right), heap);
+}
+
+static Completion evalIfExpression(IfExpression* ifExpr, const EnvironmentRef& env, bool tail) {
+	Completion condition = evalOperand(ifExpr->condition.get(), env);
+	if (condition.type == CompletionType::Error) {
+		return condition;
+	}
+
+
+	if (isTruthy(condition.value.get())) {
+		return evalBlockStatement(ifExpr->consequence.get(), env, tail);
+	}
+	else if (ifExpr->alternative != nullptr){
+		return evalBlockStatement(ifExpr->alternative.get(), env, tail);
+	}
+	else {
+		return {};
+	}
+}
+
+// evaluates exps onto the value stack in order; on an error nothing stays pushed and the error is returned
+static ObjectRef pushExpressions(const std::vector<std::unique_ptr<Expression>>& exps,
+	const EnvironmentRef& env) {
+	std::vector<ObjectRef>& valueStack = valueStackOf(env->heap);
+	size_t base = valueStack.size();
+
+	for (const auto& e : exps) {
+		Completion evaluated = evalOperand(e.get(), env);
+
+		if (evaluated.type == CompletionType::Error) {
+			popValues(valueStack, base);
+			return std::move(evaluated.value);
+		}
+
+		valueStack.push_back(std::move(evaluated.value));
+	}
+	return nullptr;
+}
+
+ObjectRef evalFunctionLiteral(FunctionLiteral* funcLit, EnvironmentRef env) {
+	Ref<Function> fn = newObject<Function>(env->heap);
+
+	for (const auto& p : funcLit->parameters)
+		fn->parameters.push_back(p.get());
+
+	fn->body = funcLit->body.get();
+	fn->code = funcLit->code;
+	fn->env = configOf(env->heap).capture.enabled ? closureEnvironment(funcLit, env) : env;
+
+	// the closure keeps its environment alive past the current call
+	if (fn->env->heap) {
+		fn->env->heap->capture(fn->env.get());
+	}
+
+	return fn;
+}
+
+// @brief value of an expression typed Integer or Boolean (see TypeInference), as an int64.
+// Typed operands can't be errors or of another kind, so whole operator trees are computed
+// without checks or intermediate objects
+static int64_t evalUnboxed(Expression* expr, const EnvironmentRef& env) {
+	if (auto* intLit = dynamic_cast<IntegerLiteral*>(expr)) {
+		return intLit->value;
+	}
+
+	if (auto* boolLit = dynamic_cast<BooleanLiteral*>(expr)) {
+		return boolLit->value;
+	}
+
+	if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+		if (prefixExpr->op == Operator::Minus) {
+			return wrappingNegate(evalUnboxed(prefixExpr->right.get(), env));
+		}
+
+		// ! of anything but a boolean is false, and typed operands have no effects to keep
+		if (prefixExpr->right->staticType == StaticType::Boolean) {
+			return !evalUnboxed(prefixExpr->right.get(), env);
+		}
+		return 0;
+	}
+
+	if (auto* infixExpr = dynamic_cast<InfixExpression*>(expr)) {
+		int64_t left = evalUnboxed(infixExpr->left.get(), env);
+		int64_t right = evalUnboxed(infixExpr->right.get(), env);
+
+		// the same arithmetic as the boxed kernels
+		switch (infixExpr->op) {
+		case Operator::Plus: return wrappingAdd(left, right);
+		case Operator::Minus: return wrappingSubtract(left, right);
+		case Operator::Asterisk: return wrappingMultiply(left, right);
+		case Operator::Slash: return wrappingDivide(left, right); // typed only for a non-zero literal divisor
+		case Operator::Lt: return left < right;
+		case Operator::Gt: return left > right;
+		case Operator::Eq: return left == right;
+		case Operator::NotEq: return left != right;
+		default: return 0;
+		}
+	}
+
+	// identifiers and ifs are evaluated as usual; only the kind check is skipped
+	ObjectRef value;
+	if (auto* ident = dynamic_cast<Identifier*>(expr)) {
+		value = *lookupIdentifier(ident, env.get());
+	}
+	else {
+		value = evalNode(expr, env).value;
+	}
+
+	if (expr->staticType == StaticType::Integer) {
+		return static_cast<Integer*>(value.get())->value;
+	}
+	return static_cast<Boolean*>(value.get())->value;
+}
+
+static ObjectRef evalTyped(Expression* expr, const EnvironmentRef& env) {
+	int64_t value = evalUnboxed(expr, env);
+
+	if (expr->staticType == StaticType::Integer) {
+		return newObject<Integer>(env->heap, value);
+	}
+	return newObject<Boolean>(env->heap, value != 0);
+}
+
+ObjectRef evalIdentifier(Identifier* ident, EnvironmentRef env) {
+
+	const ObjectRef* entry = lookupIdentifier(ident, env.get());
+
+	if (!entry) {
+		return newObject<Error>(env->heap, ErrorCode::IdentifierNotFound, ident->value);
+	}
+
+	// the stored value is returned as is: reading a variable only bumps its reference count
+	return *entry;
+}
+
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <new>
+#include "frames.hpp"
+#include "gc.hpp"
+
+bool frameEscapes(BlockStatement* body) {
+	if (body->escape == FrameEscape::Unknown) {
+		bool createsFunctions = false;
+		forEachNode(body, [&createsFunctions](Node* node) {
+			if (dynamic_cast<FunctionLiteral*>(node)) {
+				createsFunctions = true;
+			}
+		});
+
+		body->escape = createsFunctions ? FrameEscape::Escapes : FrameEscape::Contained;
+	}
+
+	return body->escape == FrameEscape::Escapes;
+}
+
+void* FrameStack::allocate(size_t bytes, size_t alignment) {
+	while (true) {
+		if (current < chunks.size()) {
+			Chunk& chunk = chunks[current];
+			size_t offset = (chunk.used + alignment - 1) & ~(alignment - 1);
+			if (offset + bytes <= chunk.size) {
+				void* ptr = chunk.memory.get() + offset;
+				frames.push_back(Frame{ current, chunk.used, ptr });
+				chunk.used = offset + bytes;
+
+				frameStats.stackFrames++;
+				frameStats.maxDepth = std::max(frameStats.maxDepth, frames.size());
+				return ptr;
+			}
+
+			// the rest of this chunk stays unused until the frames in it are released
+			if (current + 1 < chunks.size() && chunks[current + 1].size >= bytes + alignment) {
+				current++;
+				continue;
+			}
+		}
+
+		// a new chunk after the current one; chunks further on were too small
+		Chunk chunk;
+		chunk.size = std::max(chunkSize, bytes + alignment);
+		chunk.memory = std::make_unique<char[]>(chunk.size);
+		frameStats.chunksAllocated++;
+
+		current = chunks.empty() ? 0 : current + 1;
+		chunks.insert(chunks.begin() + current, std::move(chunk));
+		for (Frame& frame : frames) {
+			if (frame.chunk >= current) {
+				frame.chunk++;
+			}
+		}
+	}
+}
+
+void FrameStack::release(void* ptr) {
+	for (size_t i = frames.size(); i-- > 0;) {
+		if (frames[i].ptr == ptr) {
+			frames[i].released = true;
+			break;
+		}
+	}
+
+	while (!frames.empty() && frames.back().released) {
+		const Frame& top = frames.back();
+		chunks[top.chunk].used = top.offset;
+		current = top.chunk;
+		frames.pop_back();
+	}
+}
+
+FrameStack& frameStackOf(Heap* heap) {
+	if (heap) {
+		return heap->frameStack();
+	}
+
+	static thread_local FrameStack unowned;
+	return unowned;
+}
+
+EnvironmentRef newStackFrame(EnvironmentRef outer) {
+	FrameStack& frameStack = frameStackOf(outer ? outer->heap : nullptr);
+	auto* env = new (frameStack.allocate(sizeof(Environment), alignof(Environment))) Environment(std::move(outer));
+	env->stacked = true;
+	if (env->heap) {
+		env->heap->quota().charge(sizeof(Environment));
+	}
+	return EnvironmentRef(env);
+}
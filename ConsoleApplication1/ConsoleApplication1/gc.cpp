@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "gc.hpp"
+
+// rough footprint of a value that is about to be released, used for the bytesFreed statistic
+static size_t approximateSize(const Object* obj) {
+	if (auto* str = dynamic_cast<const String*>(obj)) {
+		return sizeof(String) + str->value.capacity();
+	}
+	if (auto* fn = dynamic_cast<const Function*>(obj)) {
+		return sizeof(Function) + fn->parameters.capacity() * sizeof(Identifier*);
+	}
+	if (dynamic_cast<const Integer*>(obj)) {
+		return sizeof(Integer);
+	}
+	if (dynamic_cast<const Boolean*>(obj)) {
+		return sizeof(Boolean);
+	}
+	return sizeof(Object);
+}
+
+EnvironmentRef Heap::newEnvironment(EnvironmentRef outer) {
+	if (!framePool.empty()) {
+		EnvironmentRef env = std::move(framePool.back());
+		framePool.pop_back();
+		env->reset(std::move(outer));
+		env->captured = env->outer == nullptr;
+		gcStats.framesReused++;
+		return env;
+	}
+
+	if (++allocatedSinceCollection >= threshold) {
+		collect();
+	}
+
+	EnvironmentRef env = allocateOld<Environment>(std::move(outer));
+	env->heap = this;
+	env->captured = env->outer == nullptr; // a global environment lives as long as the interpreter
+	env->trackedAt = environments.size();
+	environments.push_back(env.get());
+	return env;
+}
+
+void Heap::untrack(Environment* env) {
+	Environment* last = environments.back();
+	environments[env->trackedAt] = last;
+	last->trackedAt = env->trackedAt;
+	environments.pop_back();
+	env->trackedAt = Environment::untracked;
+}
+
+void Heap::recycle(EnvironmentRef env) {
+	if (env.use_count() != 1 || env->heap != this || framePool.size() >= config.framePool) {
+		return;
+	}
+
+	env->reset(nullptr);
+	framePool.push_back(std::move(env));
+}
+
+void Heap::collect() {
+	auto start = std::chrono::steady_clock::now();
+
+	// idle frames are not live: let them go with the garbage
+	framePool.clear();
+
+	// hold every tracked environment while the graph is taken apart; the ones reference
+	// counting reclaimed already left the registry
+	std::vector<EnvironmentRef> live;
+	live.reserve(environments.size());
+	for (Environment* env : environments) {
+		live.emplace_back(env);
+	}
+
+	// external reference count = total count - references coming from inside the graph
+	// (an environment's outer link, a binding or upvalue holding a closure, a binding holding an
+	// upvalue, a closure's captured environment)
+	std::unordered_map<Environment*, long> envRefs;
+	for (const auto& env : live) {
+		envRefs[env.get()] = env.use_count() - 1; // minus the snapshot itself
+	}
+
+	std::unordered_map<Function*, long> fnRefs;
+	std::unordered_map<Upvalue*, long> upvalueRefs;
+	auto countFunction = [&fnRefs](const ObjectRef& value) {
+		if (value && value->kind() == ObjectKind::Function) {
+			auto* fn = static_cast<Function*>(value.get());
+			auto [it, inserted] = fnRefs.try_emplace(fn, value.use_count());
+			it->second--;
+		}
+	};
+
+	for (const auto& env : live) {
+		if (env->outer) {
+			auto it = envRefs.find(env->outer.get());
+			if (it != envRefs.end()) {
+				it->second--;
+			}
+		}
+
+		for (const auto& [symbol, value] : env->store) {
+			if (value && value->kind() == ObjectKind::Upvalue) {
+				auto [it, inserted] = upvalueRefs.try_emplace(static_cast<Upvalue*>(value.get()), value.use_count());
+				it->second--;
+			}
+			countFunction(value);
+		}
+	}
+
+	// an upvalue holds its value once, however many environments share it
+	for (const auto& [upvalue, refs] : upvalueRefs) {
+		countFunction(upvalue->value);
+	}
+
+	for (const auto& [fn, refs] : fnRefs) {
+		if (fn->env) {
+			auto it = envRefs.find(fn->env.get());
+			if (it != envRefs.end()) {
+				it->second--;
+			}
+		}
+	}
+
+	// mark: everything reachable from an externally referenced environment or closure
+	std::unordered_set<Environment*> marked;
+	std::vector<Environment*> worklist;
+
+	auto markEnv = [&](Environment* env) {
+		if (env && envRefs.count(env) && marked.insert(env).second) {
+			worklist.push_back(env);
+		}
+	};
+
+	for (const auto& [env, refs] : envRefs) {
+		if (refs > 0) {
+			markEnv(env);
+		}
+	}
+	for (const auto& [fn, refs] : fnRefs) {
+		if (refs > 0) {
+			markEnv(fn->env.get());
+		}
+	}
+	// upvalues also shared with the frames of running calls, which the heap doesn't track
+	for (const auto& [upvalue, refs] : upvalueRefs) {
+		if (refs > 0 && upvalue->value && upvalue->value->kind() == ObjectKind::Function) {
+			markEnv(static_cast<Function*>(upvalue->value.get())->env.get());
+		}
+	}
+
+	while (!worklist.empty()) {
+		Environment* env = worklist.back();
+		worklist.pop_back();
+
+		markEnv(env->outer.get());
+		for (const auto& [symbol, value] : env->store) {
+			const Object* held = value && value->kind() == ObjectKind::Upvalue ? static_cast<Upvalue*>(value.get())->value.get() : value.get();
+			if (held && held->kind() == ObjectKind::Function) {
+				markEnv(static_cast<const Function*>(held)->env.get());
+			}
+		}
+	}
+
+	// sweep: unmarked environments are only kept alive by cycles; emptying them breaks the cycles
+	size_t freedEnvs = 0, freedObjects = 0, freedBytes = 0;
+	environments.clear();
+	for (const auto& env : live) {
+		if (marked.count(env.get())) {
+			env->trackedAt = environments.size();
+			environments.push_back(env.get());
+			continue;
+		}
+
+		env->trackedAt = Environment::untracked;
+		freedEnvs++;
+		freedBytes += sizeof(Environment) + env->store.tableBytes();
+		for (const auto& [symbol, value] : env->store) {
+			if (value && value.use_count() == 1) {
+				freedObjects++;
+				freedBytes += approximateSize(value.get());
+			}
+		}
+
+		env->store.clear();
+		env->outer.reset();
+	}
+	live.clear();
+
+	allocatedSinceCollection = 0;
+	threshold = std::max(config.initialThreshold,
+		static_cast<size_t>(static_cast<double>(environments.size()) * config.growthFactor));
+
+	auto pause = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+	gcStats.collections++;
+	gcStats.environmentsFreed += freedEnvs;
+	gcStats.objectsFreed += freedObjects;
+	gcStats.bytesFreed += freedBytes;
+	gcStats.liveEnvironments = environments.size();
+	gcStats.lastPause = pause;
+	gcStats.maxPause = std::max(gcStats.maxPause, pause);
+	gcStats.totalPause += pause;
+}
+
+Heap::~Heap() {
+	framePool.clear();
+
+	std::vector<EnvironmentRef> live;
+	live.reserve(environments.size());
+	for (Environment* env : environments) {
+		env->trackedAt = Environment::untracked;
+		live.emplace_back(env);
+	}
+	environments.clear();
+
+	for (const auto& env : live) {
+		env->store.clear();
+		env->outer.reset();
+		env->heap = nullptr;
+	}
+
+	memoryQuota->orphan();
+}
+
+ObjectRef Heap::promote(ObjectRef obj) {
+	if (!obj || !obj->young) {
+		return obj;
+	}
+
+	ObjectRef old;
+	switch (obj->kind()) {
+	case ObjectKind::Integer:
+		old = allocateOld<Integer>(static_cast<Integer*>(obj.get())->value);
+		break;
+	case ObjectKind::Boolean:
+		old = allocateOld<Boolean>(static_cast<Boolean*>(obj.get())->value);
+		break;
+	case ObjectKind::String:
+		old = newString(this, static_cast<String*>(obj.get())->value, true);
+		break;
+	case ObjectKind::Null:
+		old = allocateOld<Null>();
+		break;
+	case ObjectKind::Function: {
+		auto* fnVal = static_cast<Function*>(obj.get());
+		Ref<Function> fn = allocateOld<Function>();
+		fn->parameters = fnVal->parameters;
+		fn->body = fnVal->body;
+		fn->code = fnVal->code;
+		fn->env = fnVal->env;
+		old = fn;
+		break;
+	}
+	default:
+		// control-flow wrappers and errors are never bound to names
+		return obj;
+	}
+
+	nursery.countPromotion();
+	return old;
+}
+
+void Heap::capture(Environment* env) {
+	for (; env && !env->captured; env = env->outer.get()) {
+		env->captured = true;
+		for (auto& [symbol, value] : env->store) {
+			value = promote(std::move(value));
+		}
+	}
+}
+
+Ref<String> newString(Heap* heap, std::string value, bool old) {
+	if (!heap) {
+		return makeRef<String>(std::move(value));
+	}
+
+	if (heap->config.nursery && !old && value.size() <= heap->config.pretenureStringSize) {
+		return heap->allocateYoung<String>(std::move(value));
+	}
+
+	Ref<String> str = heap->allocateOld<String>(std::move(value));
+	MemoryQuota::chargeMore(str.get(), str->value.capacity());
+	return str;
+}
+
+EnvironmentRef newEnclosedEnvironment(EnvironmentRef outer) {
+	if (outer && outer->heap) {
+		return outer->heap->newEnvironment(std::move(outer));
+	}
+
+	return makeRef<Environment>(std::move(outer));
+}
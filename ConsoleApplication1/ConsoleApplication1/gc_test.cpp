@@ -0,0 +1,603 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include <thread>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "gc.hpp"
+#include "frames.hpp"
+#include "closures.hpp"
+#include "memoizer.hpp"
+
+// ====== HELPER FUNCTIONS ======
+
+// Runs input in an existing environment; the program is kept by the caller, whose checks
+// may look at its nodes afterwards
+static ObjectRef runIn(const std::string& input, EnvironmentRef env,
+    std::vector<std::unique_ptr<Program>>& programs) {
+    auto l = std::make_unique<Lexer>(input);
+    Parser p(l);
+    programs.push_back(p.parseProgram());
+
+    return eval(programs.back().get(), env);
+}
+
+// Runs input in an existing environment and drops the program, like the REPL does with each line
+static ObjectRef runLine(const std::string& input, EnvironmentRef env) {
+    auto l = std::make_unique<Lexer>(input);
+    Parser p(l);
+    std::unique_ptr<Program> program = p.parseProgram();
+
+    return eval(program.get(), env);
+}
+
+static bool expectInteger(Object* obj, int64_t expected) {
+    Integer* result = dynamic_cast<Integer*>(obj);
+    if (!result) {
+        std::cerr << "object is not Integer. got=" << (obj ? obj->Inspect() : "nullptr") << "\n";
+        return false;
+    }
+
+    if (result->value != expected) {
+        std::cerr << "object has wrong value. got=" << result->value
+                  << ", want=" << expected << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+// ====== TEST FUNCTIONS ======
+
+static void TestCollectsClosureCycles() {
+    GcConfig config;
+    config.initialThreshold = 1 << 20; // only collect when asked to
+    Heap heap(config);
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    // every call of make leaves behind a frame that holds 'loop', which captures that same frame
+    ObjectRef result = runIn(R"(
+        let make = fn() {
+            let loop = fn(n) { if (n < 1) { 0 } else { loop(n - 1) } };
+            loop(3)
+        };
+        make(); make(); make();
+    )", env, programs);
+
+    if (!expectInteger(result.get(), 0)) {
+        return;
+    }
+
+    if (heap.trackedEnvironments() < 4) {
+        std::cerr << "expected the cyclic frames to outlive their calls. tracked="
+                  << heap.trackedEnvironments() << "\n";
+        return;
+    }
+
+    heap.collect();
+
+    const GcStats& stats = heap.stats();
+    if (stats.collections != 1 || stats.environmentsFreed != 3) {
+        std::cerr << "wrong collection stats. collections=" << stats.collections
+                  << ", environmentsFreed=" << stats.environmentsFreed << ", want 1 and 3\n";
+        return;
+    }
+
+    if (heap.trackedEnvironments() != 1 || stats.liveEnvironments != 1) {
+        std::cerr << "only the global environment should survive. tracked="
+                  << heap.trackedEnvironments() << "\n";
+        return;
+    }
+
+    if (stats.bytesFreed == 0 || stats.objectsFreed < 3) {
+        std::cerr << "freed bytes/objects not accounted. bytes=" << stats.bytesFreed
+                  << ", objects=" << stats.objectsFreed << "\n";
+        return;
+    }
+
+    std::cout << "TestCollectsClosureCycles passed!\n";
+}
+
+static void TestKeepsReachableClosures() {
+    GcConfig config;
+    config.initialThreshold = 1 << 20;
+    Heap heap(config);
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    runIn(R"(
+        let counter = fn(x) {
+            let inner = fn(y) { if (y < 1) { x } else { inner(y - 1) } };
+            inner
+        };
+        let f = counter(7);
+    )", env, programs);
+
+    // a closure held only by the host is a root as well
+    ObjectRef held = runIn("counter(9)", env, programs);
+
+    heap.collect();
+
+    if (heap.stats().environmentsFreed != 0) {
+        std::cerr << "collected reachable environments. freed="
+                  << heap.stats().environmentsFreed << "\n";
+        return;
+    }
+
+    if (!expectInteger(runIn("f(3)", env, programs).get(), 7)) {
+        return;
+    }
+
+    auto scratch = heap.newEnvironment(env);
+    scratch->setObject("held", held);
+    if (!expectInteger(runIn("held(2)", scratch, programs).get(), 9)) {
+        return;
+    }
+
+    std::cout << "TestKeepsReachableClosures passed!\n";
+}
+
+static void TestCollectsDuringEvaluation() {
+    GcConfig config;
+    config.initialThreshold = 8; // collect constantly, while calls are still on the stack
+    Heap heap(config);
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    ObjectRef result = runIn(R"(
+        let make = fn(n) {
+            let loop = fn(k) { if (k < 1) { n } else { loop(k - 1) } };
+            loop(5)
+        };
+        let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, acc + make(n)) } };
+        sum(50, 0)
+    )", env, programs);
+
+    if (!expectInteger(result.get(), 1275)) {
+        return;
+    }
+
+    if (heap.stats().collections == 0 || heap.stats().environmentsFreed == 0) {
+        std::cerr << "expected collections while evaluating. collections="
+                  << heap.stats().collections << "\n";
+        return;
+    }
+
+    std::cout << "TestCollectsDuringEvaluation passed!\n";
+}
+
+static void TestNurseryRecyclesTemporaries() {
+    GcConfig config;
+    config.nursery = true;
+    Heap heap(config);
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    runIn("let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, acc + n * 2 - n) } };", env, programs);
+
+    for (int i = 0; i < 200; i++) {
+        if (!expectInteger(runIn("sum(20, 0)", env, programs).get(), 210)) {
+            return;
+        }
+    }
+
+    const NurseryStats& stats = heap.nurseryStats();
+    if (stats.allocations < 3000) {
+        std::cerr << "temporaries were not allocated in the nursery. allocations="
+                  << stats.allocations << "\n";
+        return;
+    }
+
+    // every temporary dies within its expression, so a couple of chunks are enough
+    if (stats.chunksAllocated > 4 || stats.chunksRecycled == 0) {
+        std::cerr << "nursery chunks were not recycled. allocated=" << stats.chunksAllocated
+                  << ", recycled=" << stats.chunksRecycled << "\n";
+        return;
+    }
+
+    std::cout << "TestNurseryRecyclesTemporaries passed!\n";
+}
+
+static void TestNurseryPromotesSurvivors() {
+    GcConfig config;
+    config.nursery = true;
+    Heap heap(config);
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    runIn(R"(
+        let x = 1 + 2;
+        let greeting = "hello" + " " + "world";
+        let makeAdder = fn(a) { let b = a * 10; fn(c) { a + b + c } };
+        let addTen = makeAdder(1 + 0);
+    )", env, programs);
+
+    for (const char* name : { "x", "greeting", "makeAdder", "addTen" }) {
+        auto [value, found] = env->getObject(std::string(name));
+        if (!found || !value || value->young) {
+            std::cerr << "global binding " << name << " was not promoted\n";
+            return;
+        }
+    }
+
+    // 'a' and 'b' live in the frame captured by addTen
+    Function* adder = dynamic_cast<Function*>(env->getObject("addTen").first.get());
+    for (const char* name : { "a", "b" }) {
+        auto [value, found] = adder->env->getObject(std::string(name));
+        if (!found || !value || value->young) {
+            std::cerr << "captured binding " << name << " was not promoted\n";
+            return;
+        }
+    }
+
+    if (!expectInteger(runIn("addTen(5)", env, programs).get(), 16)) {
+        return;
+    }
+
+    ObjectRef longString = runIn("greeting + greeting + greeting + greeting + greeting + "
+        "greeting + greeting + greeting + greeting + greeting + greeting + greeting + "
+        "greeting + greeting + greeting + greeting + greeting + greeting + greeting + greeting + greeting + greeting + greeting + greeting", env, programs);
+    if (!longString || longString->young) {
+        std::cerr << "long strings should skip the nursery\n";
+        return;
+    }
+
+    if (heap.nurseryStats().promotions == 0) {
+        std::cerr << "promotions not counted\n";
+        return;
+    }
+
+    std::cout << "TestNurseryPromotesSurvivors passed!\n";
+}
+
+static void TestRecyclesCallFrames() {
+    // each call of add returns before the next one starts, so one frame serves them all.
+    // Such frames go on the frame stack otherwise; the pool is for the ones that can escape
+    GcConfig config;
+    config.frames.enabled = false;
+    Heap heap(config);
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    ObjectRef result = runIn(R"(
+        let add = fn(a, b) { a + b };
+        let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, add(acc, n)) } };
+        sum(1000, 0)
+    )", env, programs);
+
+    if (!expectInteger(result.get(), 500500)) {
+        return;
+    }
+
+    if (heap.stats().framesReused < 1990 || heap.trackedEnvironments() > 4) {
+        std::cerr << "call frames not reused. reused=" << heap.stats().framesReused
+                  << ", tracked=" << heap.trackedEnvironments() << "\n";
+        return;
+    }
+
+    // a frame captured by a closure stays as it is, and a reused frame sees none of its old bindings
+    result = runIn(R"(
+        let makeAdder = fn(a) { fn(c) { a + c } };
+        let addTwo = makeAdder(2);
+        let probe = fn(x) { let y = x; y };
+        probe(7);
+        let peek = fn(z) { y };
+        addTwo(add(1, 2)) + probe(1)
+    )", env, programs);
+
+    if (!expectInteger(result.get(), 6)) {
+        return;
+    }
+
+    if (!isError(runIn("peek(1)", env, programs).get())) {
+        std::cerr << "a reused frame kept an old binding\n";
+        return;
+    }
+
+    std::cout << "TestRecyclesCallFrames passed!\n";
+}
+
+static void TestStackFramesForContainedCalls() {
+    Heap heap;
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+    FrameStats before = heap.frameStack().stats();
+
+    ObjectRef result = runIn(R"(
+        let add = fn(a, b) { a + b };
+        let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, add(acc, n)) } };
+        let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };
+        sum(1000, 0) + fib(15)
+    )", env, programs);
+
+    if (!expectInteger(result.get(), 501110)) {
+        return;
+    }
+
+    const FrameStats& stats = heap.frameStack().stats();
+    if (stats.stackFrames - before.stackFrames < 3000 || heap.trackedEnvironments() != 1) {
+        std::cerr << "contained calls did not use the frame stack. stackFrames="
+                  << stats.stackFrames - before.stackFrames << ", tracked=" << heap.trackedEnvironments() << "\n";
+        return;
+    }
+
+    // frames are popped as their calls return, so the same chunk serves every call
+    if (heap.frameStack().depth() != 0 || stats.chunksAllocated - before.chunksAllocated > 1) {
+        std::cerr << "frames were not released. depth=" << heap.frameStack().depth()
+                  << ", chunks=" << stats.chunksAllocated - before.chunksAllocated << "\n";
+        return;
+    }
+
+    std::cout << "TestStackFramesForContainedCalls passed!\n";
+}
+
+static void TestEscapingFramesStayOnHeap() {
+    // closures holding the whole environment they're made in, so their frames escape
+    GcConfig config;
+    config.capture.enabled = false;
+    Heap heap(config);
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    // makeAdder and counter create the closures that keep their frames; apply and pick only
+    // pass closures on, which hold frames of their own
+    ObjectRef result = runIn(R"(
+        let makeAdder = fn(a) { let b = a * 10; fn(c) { a + b + c } };
+        let counter = fn(x) {
+            let inner = fn(y) { if (y < 1) { x } else { inner(y - 1) } };
+            inner
+        };
+        let apply = fn(f, x) { f(x) };
+        let pick = fn(f, g, first) { if (first) { f } else { g } };
+        let addTen = makeAdder(1);
+        let seven = counter(7);
+        apply(addTen, 5) + apply(pick(seven, addTen, true), 3) + pick(makeAdder(2), seven, true)(1)
+    )", env, programs);
+
+    if (!expectInteger(result.get(), 16 + 7 + 23)) {
+        return;
+    }
+
+    auto bodyOf = [&env](const std::string& name) {
+        return static_cast<Function*>(env->getObject(name).first.get())->body;
+    };
+
+    if (!frameEscapes(bodyOf("makeAdder")) || !frameEscapes(bodyOf("counter"))
+        || frameEscapes(bodyOf("apply")) || frameEscapes(bodyOf("pick"))) {
+        std::cerr << "wrong escape analysis\n";
+        return;
+    }
+
+    // the frames addTen and seven captured live on the heap and kept their bindings
+    if (heap.trackedEnvironments() < 3 || heap.frameStack().depth() != 0) {
+        std::cerr << "captured frames not kept. tracked=" << heap.trackedEnvironments()
+                  << ", depth=" << heap.frameStack().depth() << "\n";
+        return;
+    }
+
+    if (!expectInteger(runIn("addTen(0) + seven(4)", env, programs).get(), 18)) {
+        return;
+    }
+
+    std::cout << "TestEscapingFramesStayOnHeap passed!\n";
+}
+
+static void TestSharesValuesAcrossThreads() {
+    Heap heap;
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    ObjectRef sum = runIn("let f = fn(x) { x * 2 }; f(21)", env, programs);
+    ObjectRef text = runIn(R"("shared" + " text")", env, programs);
+
+    // copies handed over with atomic counts; the originals stay with this interpreter
+    std::vector<SharedValue> shared = { shareValue(sum.get()), shareValue(text.get()) };
+    if (!shared[0] || !shared[1] || shared[0].get() == sum.get()
+        || shareValue(env->getObject("f").first.get())) {
+        std::cerr << "wrong values shared\n";
+        return;
+    }
+
+    std::vector<ObjectRef> received;
+    std::thread receiver([&shared, &received]() {
+        for (const SharedValue& value : shared) {
+            received.push_back(unshareValue(value));
+        }
+    });
+    receiver.join();
+    shared.clear();
+
+    if (!expectInteger(received[0].get(), 42) || received[0].use_count() != 1) {
+        return;
+    }
+
+    String* str = dynamic_cast<String*>(received[1].get());
+    if (!str || str->value != "shared text" || sum.use_count() != 1) {
+        std::cerr << "value not copied back. got=" << received[1]->Inspect() << "\n";
+        return;
+    }
+
+    std::cout << "TestSharesValuesAcrossThreads passed!\n";
+}
+
+static void TestInterpretersOnTwoThreads() {
+    // each thread parses and runs its own program on its own heap: frames, closures, memo tables
+    // flushed by a rebinding, and names interned while the other thread interns its own
+    auto run = [](int64_t seed, ObjectRef& result, size_t& depth, size_t& memoHits) {
+        GcConfig config;
+        config.memo.enabled = true;
+        Heap heap(config);
+        std::vector<std::unique_ptr<Program>> programs;
+        auto env = heap.newEnvironment(nullptr);
+        std::string offset = std::to_string(seed);
+        runIn("let offset = " + offset + "; let name" + offset + " = offset;", env, programs);
+        result = runIn(R"(
+            let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } };
+            let make = fn(a) { let b = a * 2; fn(c) { a + b + c } };
+            let sum = fn(n, acc) { if (n < 1) { acc } else { sum(n - 1, acc + make(n)(offset)) } };
+            let first = fib(20) + sum(500, 0);
+            let offset = offset + 1;
+            first + fib(20) + sum(500, 0)
+        )", env, programs);
+        result = heap.promote(result);
+        depth = heap.frameStack().depth();
+        memoHits = memoStats.hits;
+    };
+
+    ObjectRef results[2];
+    size_t depths[2] = {};
+    size_t hits[2] = {};
+    std::thread first(run, 1, std::ref(results[0]), std::ref(depths[0]), std::ref(hits[0]));
+    std::thread second(run, 2, std::ref(results[1]), std::ref(depths[1]), std::ref(hits[1]));
+    first.join();
+    second.join();
+
+    // fib(20) = 6765; sum(500) adds 3n + offset for each n
+    for (int64_t i = 0; i < 2; i++) {
+        int64_t offset = i + 1;
+        int64_t expected = 2 * (6765 + 3 * 125250) + 500 * offset + 500 * (offset + 1);
+        if (!expectInteger(results[i].get(), expected)) {
+            return;
+        }
+
+        if (depths[i] != 0 || hits[i] == 0) {
+            std::cerr << "interpreters interfered. depth=" << depths[i] << ", memo hits=" << hits[i] << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestInterpretersOnTwoThreads passed!\n";
+}
+
+static void TestFunctionsOwnTheirCode() {
+    Heap heap;
+    auto env = heap.newEnvironment(nullptr);
+
+    runLine("let make = fn(x) { fn(y) { x + y } }; let addTwo = make(2);", env);
+
+    // the line is gone, the code of both functions it made is not
+    std::weak_ptr<const FunctionCode> outer = static_cast<Function*>(env->getObject("make").first.get())->code;
+    std::weak_ptr<const FunctionCode> inner = static_cast<Function*>(env->getObject("addTwo").first.get())->code;
+    if (outer.expired() || inner.expired()) {
+        std::cerr << "function code freed with its line\n";
+        return;
+    }
+
+    if (!expectInteger(runLine("let addThree = make(3); addTwo(5) + addThree(5)", env).get(), 15)) {
+        return;
+    }
+
+    // rebinding drops the functions, and their code with them
+    runLine("let make = 0; let addTwo = 0; let addThree = 0;", env);
+    heap.collect();
+
+    if (!outer.expired() || !inner.expired()) {
+        std::cerr << "function code kept after its functions went away\n";
+        return;
+    }
+
+    std::cout << "TestFunctionsOwnTheirCode passed!\n";
+}
+
+static void TestMemoryLimit() {
+    GcConfig config;
+    config.memoryLimit = 160 * 1024;
+    Heap heap(config);
+    std::vector<std::unique_ptr<Program>> programs;
+    auto env = heap.newEnvironment(nullptr);
+
+    runIn(R"(
+        let grow = fn(s, n) { if (n < 1) { s } else { grow(s + s, n - 1) } };
+        let deep = fn(n) { if (n < 1) { 0 } else { 1 + deep(n - 1) } };
+    )", env, programs);
+    size_t before = heap.memoryStats().bytesInUse;
+
+    // a runaway concatenation and a runaway recursion both stop with an error
+    for (const char* input : { "grow(\"ab\", 40)", "deep(100000)" }) {
+        ObjectRef result = runIn(input, env, programs);
+        Error* err = dynamic_cast<Error*>(result.get());
+        if (!err || err->message() != "memory limit exceeded") {
+            std::cerr << input << " not stopped. got=" << (result ? result->Inspect() : "nullptr") << "\n";
+            return;
+        }
+    }
+
+    // the limit is checked before each call, so the values one call makes before the next check
+    // may go past it; they never add up to another frame
+    const MemoryStats& stats = heap.memoryStats();
+    if (stats.refusals != 2 || stats.peakBytes > config.memoryLimit + sizeof(Environment) || stats.allocations == 0
+        || stats.frees == 0) {
+        std::cerr << "wrong memory stats. refusals=" << stats.refusals << ", peak=" << stats.peakBytes
+                  << ", allocations=" << stats.allocations << ", frees=" << stats.frees << "\n";
+        return;
+    }
+
+    // what the stopped evaluations held was given back, and the interpreter goes on
+    if (stats.bytesInUse > before + Nursery::chunkSize) {
+        std::cerr << "memory not given back. before=" << before << ", after=" << stats.bytesInUse << "\n";
+        return;
+    }
+
+    if (!expectInteger(runIn("deep(10)", env, programs).get(), 10)) {
+        return;
+    }
+
+    // a string that outlives the interpreter is credited to its quota all the same
+    GcConfig old;
+    old.nursery = false;
+    ObjectRef kept;
+    {
+        Heap other(old);
+        auto otherEnv = other.newEnvironment(nullptr);
+        kept = runIn(R"("outlives" + " its heap")", otherEnv, programs);
+        if (other.memoryStats().bytesInUse < sizeof(String) + 18) {
+            std::cerr << "string not charged. inUse=" << other.memoryStats().bytesInUse << "\n";
+            return;
+        }
+    }
+
+    if (kept->Inspect() != "outlives its heap") {
+        std::cerr << "wrong string kept. got=" << kept->Inspect() << "\n";
+        return;
+    }
+
+    // so are the upvalues closures share and the errors evaluation stops with
+    {
+        Heap other(old);
+        auto otherEnv = other.newEnvironment(nullptr);
+        runIn("let shared = 1;", otherEnv, programs);
+        size_t held = other.memoryStats().bytesInUse;
+        Ref<Upvalue> box = otherEnv->upvalue(intern("shared"));
+        ObjectRef error = runIn("missing", otherEnv, programs);
+        if (other.memoryStats().bytesInUse < held + sizeof(Upvalue) + sizeof(Error)) {
+            std::cerr << "upvalue or error not charged. before=" << held << ", after="
+                      << other.memoryStats().bytesInUse << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestMemoryLimit passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestCollectsClosureCycles();
+//    TestKeepsReachableClosures();
+//    TestCollectsDuringEvaluation();
+//    TestNurseryRecyclesTemporaries();
+//    TestNurseryPromotesSurvivors();
+//    TestRecyclesCallFrames();
+//    TestStackFramesForContainedCalls();
+//    TestEscapingFramesStayOnHeap();
+//    TestSharesValuesAcrossThreads();
+//    TestInterpretersOnTwoThreads();
+//    TestFunctionsOwnTheirCode();
+//    TestMemoryLimit();
+//    return 0;
+//}
@@ -0,0 +1,121 @@
+#include "inline_cache.hpp"
+
+// env's binding of ident, when env is the one the cache points at or binds the name itself
+static const ObjectRef* lookupAt(Identifier* ident, Environment* env, size_t depth) {
+	IdentifierCache& cache = ident->cache;
+
+	if (cache.env == env && cache.serial == env->serial) {
+		cache.depth = depth;
+		return cache.entry;
+	}
+
+	ObjectRef* entry = env->store.find(ident->symbol);
+	if (!entry) {
+		return nullptr;
+	}
+
+	if (kindOf(entry->get()) == ObjectKind::Upvalue) {
+		// a closure captured the binding: its value lives in the upvalue, once a let has bound it
+		entry = &static_cast<Upvalue*>(entry->get())->value;
+		if (!*entry) {
+			return nullptr;
+		}
+	}
+
+	cache.env = env;
+	cache.serial = env->serial;
+	cache.depth = depth;
+	cache.entry = entry; // bindings are never erased, and the serial changes when entries move or get boxed
+	return cache.entry;
+}
+
+const ObjectRef* lookupIdentifier(Identifier* ident, Environment* env) {
+	IdentifierCache& cache = ident->cache;
+
+	if (cache.entry) {
+		Environment* target = env;
+		size_t depth = 0;
+
+		while (target && depth < cache.depth) {
+			// a nearer binding shadows the cached one
+			if ((target->nameMask & ident->bit) && target->store.find(ident->symbol)) {
+				break;
+			}
+
+			target = target->outer.get();
+			depth++;
+		}
+
+		if (target && depth == cache.depth) {
+			if (const ObjectRef* entry = lookupAt(ident, target, depth)) {
+				cache.hits++;
+				return entry;
+			}
+		}
+	}
+
+	cache.misses++;
+
+	size_t depth = 0;
+	for (Environment* target = env; target; target = target->outer.get(), depth++) {
+		if (const ObjectRef* entry = lookupAt(ident, target, depth)) {
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+Function* resolveCallee(CallExpression* site, Object* fn) {
+	if (!fn || fn->kind() != ObjectKind::Function) {
+		return nullptr;
+	}
+
+	Function* function = static_cast<Function*>(fn);
+
+	if (site) {
+		CallSiteCache& cache = site->cache;
+		uint64_t code = function->code ? function->code->serial : 0;
+
+		if (code && cache.code == code) {
+			cache.hits++;
+		}
+		else {
+			cache.misses++;
+			cache.code = code;
+			cache.arity = function->parameters.size();
+			cache.directBind = cache.arity <= Bindings::inlineCapacity;
+			for (size_t i = 0; i < cache.arity && cache.directBind; i++) {
+				for (size_t j = 0; j < i; j++) {
+					if (function->parameters[i]->symbol == function->parameters[j]->symbol) {
+						cache.directBind = false;
+					}
+				}
+			}
+		}
+	}
+
+	return function;
+}
+
+InlineCacheStats collectInlineCacheStats(Node* root) {
+	InlineCacheStats stats;
+
+	forEachNode(root, [&stats](Node* node) {
+		if (auto* ident = dynamic_cast<Identifier*>(node)) {
+			stats.identifierHits += ident->cache.hits;
+			stats.identifierMisses += ident->cache.misses;
+		}
+		else if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
+			stats.callHits += callExpr->cache.hits;
+			stats.callMisses += callExpr->cache.misses;
+		}
+	});
+
+	return stats;
+}
+
+void printInlineCacheStats(std::ostream& out, const InlineCacheStats& stats) {
+	out << "identifier caches: " << stats.identifierHits << " hits, " << stats.identifierMisses << " misses\n";
+	out << "call site caches: " << stats.callHits << " hits, " << stats.callMisses << " misses\n";
+}
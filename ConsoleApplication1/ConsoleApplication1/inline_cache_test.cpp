@@ -0,0 +1,202 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "inline_cache.hpp"
+#include "test_helpers.hpp"
+
+// ====== HELPER FUNCTIONS ======
+
+static bool expectInteger(Object* obj, int64_t expected, const std::string& input) {
+    Integer* result = dynamic_cast<Integer*>(obj);
+    if (!result || result->value != expected) {
+        std::cerr << "wrong result for \"" << input << "\". expected=" << expected << ", got="
+                  << (obj ? obj->Inspect() : "nullptr") << "\n";
+        return false;
+    }
+    return true;
+}
+
+// ====== TEST FUNCTIONS ======
+
+static void TestIdentifierCacheHits() {
+    std::string input =
+        "let k = 3;"
+        "let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1, acc + k) } };"
+        "loop(1000, 0);";
+    std::unique_ptr<Program> program = parse(input);
+    ObjectRef evaluated = eval(program.get(), makeRef<Environment>());
+
+    if (!expectInteger(evaluated.get(), 3000, input)) {
+        return;
+    }
+
+    // every identifier node misses once, then keeps resolving at the same depth
+    InlineCacheStats stats = collectInlineCacheStats(program.get());
+    if (stats.identifierMisses > 10 || stats.identifierHits < 4990) {
+        std::cerr << "identifier caches not hit. hits=" << stats.identifierHits
+                  << ", misses=" << stats.identifierMisses << "\n";
+        return;
+    }
+
+    if (stats.callMisses != 2 || stats.callHits != 999) {
+        std::cerr << "wrong call site counters. hits=" << stats.callHits
+                  << ", misses=" << stats.callMisses << "\n";
+        return;
+    }
+
+    std::cout << "TestIdentifierCacheHits passed!\n";
+}
+
+static void TestIdentifierCacheShadowing() {
+    std::vector<std::pair<std::string, int64_t>> tests = {
+        // the same x node first resolves to the global, then to a local bound in the call
+        {"let x = 1; let g = fn(flag) { if (flag) { let x = 100; } x }; g(false) + g(true) + g(false)", 102},
+        // rebinding a global is seen through the cached entry
+        {"let y = 5; let h = fn() { y }; let a = h(); let y = 6; a * 10 + h()", 56},
+        // one closure node seeing a different captured environment on every call
+        {"let adder = fn(n) { fn(m) { n + m } }; let a = adder(1); let b = adder(10); a(1) + b(1) + a(2)", 16},
+        // a call site switching callees
+        {"let inc = fn(v) { v + 1 }; let dbl = fn(v) { v * 2 }; let apply = fn(f, v) { f(v) };"
+         "apply(inc, 1) + apply(dbl, 5) + apply(inc, 7)", 20},
+    };
+
+    for (const auto& [input, expected] : tests) {
+        std::unique_ptr<Program> program = parse(input);
+        ObjectRef evaluated = eval(program.get(), makeRef<Environment>());
+
+        if (!expectInteger(evaluated.get(), expected, input)) {
+            return;
+        }
+    }
+
+    std::unique_ptr<Program> program = parse("let f = fn() { z }; f()");
+    ObjectRef evaluated = eval(program.get(), makeRef<Environment>());
+    Error* err = dynamic_cast<Error*>(evaluated.get());
+    if (!err || err->message() != "identifier not found: z") {
+        std::cerr << "expected identifier not found. got=" << (evaluated ? evaluated->Inspect() : "nullptr") << "\n";
+        return;
+    }
+
+    std::cout << "TestIdentifierCacheShadowing passed!\n";
+}
+
+static void TestIdentifierCacheEnvironmentReuse() {
+    // environments freed between calls may come back at the same address; the serial tells them apart
+    std::unique_ptr<Program> program = parse("let f = fn(a) { fn() { a } }; f");
+    EnvironmentRef env = makeRef<Environment>();
+    ObjectRef f = eval(program.get(), env);
+
+    for (int64_t i = 0; i < 100; i++) {
+        std::unique_ptr<Program> call = parse("f(" + std::to_string(i) + ")");
+        ObjectRef inner = eval(call.get(), env);
+        Function* fn = dynamic_cast<Function*>(inner.get());
+        if (!fn) {
+            std::cerr << "expected a function\n";
+            return;
+        }
+
+        ObjectRef evaluated = eval(fn->body, makeRef<Environment>(fn->env));
+        if (!expectInteger(evaluated.get(), i, "inner call " + std::to_string(i))) {
+            return;
+        }
+    }
+
+    std::cout << "TestIdentifierCacheEnvironmentReuse passed!\n";
+}
+
+static void TestIdentifierCacheScopeGrowth() {
+    // the global scope outgrows the bindings kept inline, then its table doubles, while
+    // identifier nodes hold on to entries they resolved before
+    auto env = makeRef<Environment>();
+    std::unique_ptr<Program> first = parse("let a = 1; let f = fn() { a }; f()");
+    if (!expectInteger(eval(first.get(), env).get(), 1, "f()")) {
+        return;
+    }
+
+    // identifiers are letters only: v, then i in base 26
+    auto name = [](int i) {
+        return std::string("v") + static_cast<char>('a' + i / 26) + static_cast<char>('a' + i % 26);
+    };
+
+    std::string lets;
+    for (int i = 0; i < 100; i++) {
+        lets += "let " + name(i) + " = " + std::to_string(i) + "; f();";
+    }
+    lets += "let a = 7;";
+    std::unique_ptr<Program> second = parse(lets);
+    eval(second.get(), env);
+
+    if (!expectInteger(eval(first.get(), env).get(), 1, "let a = 1; f()")) {
+        return;
+    }
+
+    std::string sum = "f() + " + name(0) + " + " + name(42) + " + " + name(99);
+    std::unique_ptr<Program> third = parse(sum);
+    if (!expectInteger(eval(third.get(), env).get(), 142, sum)) {
+        return;
+    }
+
+    if (env->store.size() != 102 || env->getObject(name(100)).second || !env->getObject(name(57)).second) {
+        std::cerr << "wrong bindings after growth. size=" << env->store.size() << "\n";
+        return;
+    }
+
+    std::cout << "TestIdentifierCacheScopeGrowth passed!\n";
+}
+
+static void TestCallSiteCacheBindsParameters() {
+    std::vector<std::pair<std::string, int64_t>> tests = {
+        // distinct parameters, appended to the frame once the site has seen the callee
+        {"let sub = fn(a, b) { a - b }; let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1, acc + sub(n, 1)) } }; loop(100, 0)", 4950},
+        // a name listed twice takes the last argument
+        {"let same = fn(a, a) { a }; let f = fn(x) { same(x, x + 1) }; f(1) + f(10)", 13},
+        // more parameters than a frame binds inline
+        {"let s = fn(a, b, c, d, e, f, g) { a * b + g }; let t = fn(x) { s(x, 2, 0, 0, 0, 0, 1) }; t(1) + t(5)", 14},
+        // a site switching between callees of either kind
+        {"let one = fn(a, b) { a }; let two = fn(b, b) { b }; let apply = fn(f) { f(1, 2) };"
+         "apply(one) * 100 + apply(two) * 10 + apply(one)", 121},
+    };
+
+    for (const auto& [input, expected] : tests) {
+        std::unique_ptr<Program> program = parse(input);
+        ObjectRef evaluated = eval(program.get(), makeRef<Environment>());
+
+        if (!expectInteger(evaluated.get(), expected, input)) {
+            return;
+        }
+    }
+
+    std::unique_ptr<Program> program = parse("let add = fn(a, b) { a + b }; let twice = fn(c, c) { c }; add(1, 2) + twice(3, 4)");
+    eval(program.get(), makeRef<Environment>());
+
+    std::vector<bool> direct;
+    forEachNode(program.get(), [&direct](Node* node) {
+        if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
+            direct.push_back(callExpr->cache.directBind);
+        }
+    });
+
+    if (direct != std::vector<bool>{ true, false }) {
+        std::cerr << "wrong call sites binding directly\n";
+        return;
+    }
+
+    std::cout << "TestCallSiteCacheBindsParameters passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestIdentifierCacheHits();
+//    TestIdentifierCacheShadowing();
+//    TestIdentifierCacheEnvironmentReuse();
+//    TestIdentifierCacheScopeGrowth();
+//    TestCallSiteCacheBindsParameters();
+//    return 0;
+//}
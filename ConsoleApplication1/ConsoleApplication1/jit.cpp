@@ -0,0 +1,758 @@
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <unordered_map>
+#include <unordered_set>
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define MONKEY_JIT 1
+#endif
+#include "jit.hpp"
+#include "gc.hpp"
+
+thread_local JitStats jitStats;
+
+namespace {
+
+// native calls that may give up before a body goes back to being interpreted for good
+constexpr size_t maxBailouts = 64;
+
+// arguments are copied into a fixed array on the way in
+constexpr size_t maxArity = 16;
+
+// ====== ASSEMBLER ======
+
+// @brief x86-64 encoder for the handful of instructions the compiler below uses, with
+// labels for rel32 jumps and calls that are patched once the code is complete
+class Assembler {
+public:
+	std::vector<uint8_t> bytes;
+
+	void emit(std::initializer_list<uint8_t> code) {
+		bytes.insert(bytes.end(), code);
+	}
+
+	void imm32(int32_t value) {
+		for (int i = 0; i < 4; i++) {
+			bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	void imm64(int64_t value) {
+		for (int i = 0; i < 8; i++) {
+			bytes.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+		}
+	}
+
+	size_t label() {
+		labels.push_back(SIZE_MAX);
+		return labels.size() - 1;
+	}
+
+	void bind(size_t label) {
+		labels[label] = bytes.size();
+	}
+
+	void jmp(size_t label) {
+		emit({ 0xE9 });
+		fixup(label);
+	}
+
+	// jcc rel32, cc is the second opcode byte (0x84 je, 0x85 jne, 0x88 js)
+	void jcc(uint8_t cc, size_t label) {
+		emit({ 0x0F, cc });
+		fixup(label);
+	}
+
+	void call(size_t label) {
+		emit({ 0xE8 });
+		fixup(label);
+	}
+
+	void movRaxImm(int64_t value) { // mov rax, imm64
+		emit({ 0x48, 0xB8 });
+		imm64(value);
+	}
+
+	void loadRax(int32_t offset) { // mov rax, [rbp + offset]
+		emit({ 0x48, 0x8B, 0x85 });
+		imm32(offset);
+	}
+
+	void storeRax(int32_t offset) { // mov [rbp + offset], rax
+		emit({ 0x48, 0x89, 0x85 });
+		imm32(offset);
+	}
+
+	void addRsp(int32_t value) { // add rsp, imm32
+		emit({ 0x48, 0x81, 0xC4 });
+		imm32(value);
+	}
+
+	void subRsp(int32_t value) { // sub rsp, imm32
+		emit({ 0x48, 0x81, 0xEC });
+		imm32(value);
+	}
+
+	// resolves every jump; false if one targets a label that was never bound
+	bool finish() {
+		for (const auto& [at, label] : fixups) {
+			if (labels[label] == SIZE_MAX) {
+				return false;
+			}
+
+			int32_t rel = static_cast<int32_t>(labels[label] - (at + 4));
+			std::memcpy(&bytes[at], &rel, sizeof(rel));
+		}
+
+		return true;
+	}
+
+private:
+	std::vector<size_t> labels;
+	std::vector<std::pair<size_t, size_t>> fixups;
+
+	void fixup(size_t label) {
+		fixups.push_back({ bytes.size(), label });
+		imm32(0);
+	}
+};
+
+// ====== COMPILER ======
+
+// Never = control left the function (a return, or an if whose branches all return)
+enum class JitType { Int, Bool, None, Never, Invalid };
+
+bool isValue(JitType type) {
+	return type == JitType::Int || type == JitType::Bool;
+}
+
+enum class BlockMode {
+	Tail,    // the block's value is the function's result
+	Value,   // the block's value is left in rax
+	Discard, // the block only runs for its returns
+};
+
+// @brief compiles one function body into an entry stub plus the body itself.
+//
+// The entry stub is called from C++ as Entry(args, bailed, depth). It keeps bailed in r12
+// and the remaining depth in r13, remembers its stack pointer in r14 and pushes the
+// arguments. Giving up anywhere, however deep, sets *bailed and resets the stack to r14.
+//
+// The body keeps every value in rax, with operands waiting on the machine stack. Parameters
+// are the caller's pushed arguments at [rbp + 16 + 8 * i], lets sit below rbp. Integers and
+// booleans (0 or 1) are plain int64s; a self call in tail position overwrites the
+// parameters and jumps back to the top of the body
+class BodyCompiler {
+public:
+	BodyCompiler(Function* function, const std::string& selfName, JitType returnType)
+		: function(function), selfName(selfName), returnType(returnType) {}
+
+	// false when the body uses anything the compiler doesn't handle
+	bool compile() {
+		const auto& statements = function->body->statements;
+		arity = function->parameters.size();
+
+		for (size_t i = 0; i < arity; i++) {
+			slots[function->parameters[i]->value] = { 16 + 8 * static_cast<int32_t>(i), JitType::Int };
+		}
+
+		size_t lets = 0;
+		for (const auto& stmt : statements) {
+			if (dynamic_cast<LetStatement*>(stmt.get())) {
+				lets++;
+			}
+		}
+
+		bodyLabel = a.label();
+		startLabel = a.label();
+		returnLabel = a.label();
+		bailLabel = a.label();
+		size_t exitLabel = a.label();
+
+		// entry stub
+		a.emit({ 0x55 });             // push rbp
+		a.emit({ 0x48, 0x89, 0xE5 }); // mov rbp, rsp
+		a.emit({ 0x41, 0x54 });       // push r12
+		a.emit({ 0x41, 0x55 });       // push r13
+		a.emit({ 0x41, 0x56 });       // push r14
+		a.emit({ 0x49, 0x89, 0xF4 }); // mov r12, rsi
+		a.emit({ 0x49, 0x89, 0xD5 }); // mov r13, rdx
+		a.emit({ 0x49, 0x89, 0xE6 }); // mov r14, rsp
+		for (size_t i = arity; i-- > 0;) {
+			a.emit({ 0xFF, 0xB7 });   // push qword [rdi + 8 * i]
+			a.imm32(static_cast<int32_t>(8 * i));
+		}
+		a.call(bodyLabel);
+		a.bind(exitLabel);
+		a.emit({ 0x4C, 0x89, 0xF4 }); // mov rsp, r14
+		a.emit({ 0x41, 0x5E });       // pop r14
+		a.emit({ 0x41, 0x5D });       // pop r13
+		a.emit({ 0x41, 0x5C });       // pop r12
+		a.emit({ 0x5D });             // pop rbp
+		a.emit({ 0xC3 });             // ret
+
+		a.bind(bailLabel);
+		a.emit({ 0x49, 0xC7, 0x04, 0x24 }); // mov qword [r12], 1
+		a.imm32(1);
+		a.jmp(exitLabel);
+
+		// body
+		a.bind(bodyLabel);
+		a.emit({ 0x55 });             // push rbp
+		a.emit({ 0x48, 0x89, 0xE5 }); // mov rbp, rsp
+		if (lets > 0) {
+			a.subRsp(static_cast<int32_t>(8 * lets));
+		}
+		a.emit({ 0x49, 0x83, 0xED, 0x01 }); // sub r13, 1
+		a.jcc(0x88, bailLabel);             // js bail
+		a.bind(startLabel);
+
+		if (compileBlock(statements, BlockMode::Tail, true) != JitType::Never) {
+			return false;
+		}
+
+		a.bind(returnLabel);
+		a.emit({ 0x49, 0x83, 0xC5, 0x01 }); // add r13, 1
+		a.emit({ 0x48, 0x89, 0xEC });       // mov rsp, rbp
+		a.emit({ 0x5D });                   // pop rbp
+		a.emit({ 0xC3 });                   // ret
+
+		return a.finish();
+	}
+
+	const std::vector<uint8_t>& code() const {
+		return a.bytes;
+	}
+
+private:
+	struct Slot {
+		int32_t offset; // from rbp
+		JitType type;
+	};
+
+	Function* function;
+	std::string selfName;
+	JitType returnType;
+	size_t arity = 0;
+
+	Assembler a;
+	std::unordered_map<std::string, Slot> slots;
+	int32_t nextLocal = -8;
+	size_t bodyLabel = 0, startLabel = 0, returnLabel = 0, bailLabel = 0;
+
+	// top = the function body itself, the only block lets are allowed in (a let in a branch
+	// binds the name only when the branch runs)
+	JitType compileBlock(const std::vector<std::unique_ptr<Statement>>& statements, BlockMode mode, bool top) {
+		JitType result = JitType::None;
+
+		for (size_t i = 0; i < statements.size(); i++) {
+			Statement* stmt = statements[i].get();
+			bool last = i + 1 == statements.size();
+
+			// nothing after a return runs
+			if (auto* returnStmt = dynamic_cast<ReturnStatement*>(stmt)) {
+				return compileTail(returnStmt->value.get());
+			}
+
+			if (auto* letStmt = dynamic_cast<LetStatement*>(stmt)) {
+				const std::string& name = letStmt->name->value;
+				if (!top || slots.count(name) || name == selfName) {
+					return JitType::Invalid;
+				}
+
+				JitType type = compileExpression(letStmt->value.get());
+				if (!isValue(type)) {
+					return JitType::Invalid;
+				}
+
+				a.storeRax(nextLocal);
+				slots[name] = { nextLocal, type };
+				nextLocal -= 8;
+				result = JitType::None;
+				continue;
+			}
+
+			auto* exprStmt = dynamic_cast<ExpressionStatement*>(stmt);
+			if (!exprStmt) {
+				return JitType::Invalid;
+			}
+
+			if (last && mode == BlockMode::Tail) {
+				return compileTail(exprStmt->value.get());
+			}
+
+			JitType type = last && mode == BlockMode::Value
+				? compileExpression(exprStmt->value.get())
+				: compileDiscarded(exprStmt->value.get());
+			if (type == JitType::Invalid) {
+				return JitType::Invalid;
+			}
+			result = type;
+		}
+
+		// a function whose body ends without a value returns NULL, which has no native form
+		if (mode == BlockMode::Tail) {
+			return JitType::Invalid;
+		}
+
+		return mode == BlockMode::Value ? result : JitType::None;
+	}
+
+	// code returning the value of expr from the function
+	JitType compileTail(Expression* expr) {
+		if (auto* callExpr = dynamic_cast<CallExpression*>(expr)) {
+			if (!pushArguments(callExpr, false)) {
+				return JitType::Invalid;
+			}
+
+			for (size_t i = arity; i-- > 0;) {
+				a.emit({ 0x58 }); // pop rax
+				a.storeRax(16 + 8 * static_cast<int32_t>(i));
+			}
+			a.jmp(startLabel);
+			return JitType::Never;
+		}
+
+		if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			return compileIf(ifExpr, BlockMode::Tail);
+		}
+
+		if (compileExpression(expr) != returnType) {
+			return JitType::Invalid;
+		}
+
+		a.jmp(returnLabel);
+		return JitType::Never;
+	}
+
+	// an expression statement whose value is thrown away
+	JitType compileDiscarded(Expression* expr) {
+		if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			return compileIf(ifExpr, BlockMode::Discard);
+		}
+
+		JitType type = compileExpression(expr);
+		return isValue(type) ? JitType::None : type;
+	}
+
+	JitType compileIf(IfExpression* ifExpr, BlockMode mode) {
+		JitType condition = compileExpression(ifExpr->condition.get());
+		if (!isValue(condition)) {
+			return JitType::Invalid;
+		}
+
+		// integers are always truthy
+		if (condition == JitType::Int) {
+			return compileBlock(ifExpr->consequence->statements, mode, false);
+		}
+
+		size_t elseLabel = a.label();
+		size_t endLabel = a.label();
+
+		a.emit({ 0x48, 0x85, 0xC0 }); // test rax, rax
+		a.jcc(0x84, elseLabel);       // je else
+		JitType consequence = compileBlock(ifExpr->consequence->statements, mode, false);
+		a.jmp(endLabel);
+
+		a.bind(elseLabel);
+		JitType alternative = JitType::None;
+		if (ifExpr->alternative) {
+			alternative = compileBlock(ifExpr->alternative->statements, mode, false);
+		}
+		else if (mode == BlockMode::Tail) {
+			return JitType::Invalid; // the function would return NULL
+		}
+		a.bind(endLabel);
+
+		if (consequence == JitType::Invalid || alternative == JitType::Invalid) {
+			return JitType::Invalid;
+		}
+
+		// eval hands a return inside an if whose value is used on as a ReturnValue object
+		if (mode == BlockMode::Value && (consequence == JitType::Never || alternative == JitType::Never)) {
+			return JitType::Invalid;
+		}
+		if (consequence == JitType::Never) {
+			return alternative;
+		}
+		if (alternative == JitType::Never || consequence == alternative) {
+			return consequence;
+		}
+
+		return JitType::None; // no single type; fine as long as nothing uses the value
+	}
+
+	// code leaving the value of expr in rax
+	JitType compileExpression(Expression* expr) {
+		if (auto* intLit = dynamic_cast<IntegerLiteral*>(expr)) {
+			a.movRaxImm(intLit->value);
+			return JitType::Int;
+		}
+
+		if (auto* boolLit = dynamic_cast<BooleanLiteral*>(expr)) {
+			a.movRaxImm(boolLit->value ? 1 : 0);
+			return JitType::Bool;
+		}
+
+		if (auto* ident = dynamic_cast<Identifier*>(expr)) {
+			auto slot = slots.find(ident->value);
+			if (slot == slots.end()) {
+				return JitType::Invalid; // a free variable, which could change between calls
+			}
+
+			a.loadRax(slot->second.offset);
+			return slot->second.type;
+		}
+
+		if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+			JitType right = compileExpression(prefixExpr->right.get());
+
+			if (prefixExpr->op == Operator::Minus && right == JitType::Int) {
+				a.emit({ 0x48, 0xF7, 0xD8 }); // neg rax
+				return JitType::Int;
+			}
+
+			if (prefixExpr->op == Operator::Bang && right == JitType::Bool) {
+				a.emit({ 0x48, 0x83, 0xF0, 0x01 }); // xor rax, 1
+				return JitType::Bool;
+			}
+
+			if (prefixExpr->op == Operator::Bang && right == JitType::Int) {
+				a.movRaxImm(0);
+				return JitType::Bool;
+			}
+
+			return JitType::Invalid;
+		}
+
+		if (auto* infixExpr = dynamic_cast<InfixExpression*>(expr)) {
+			return compileInfix(infixExpr);
+		}
+
+		if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			return compileIf(ifExpr, BlockMode::Value);
+		}
+
+		if (auto* callExpr = dynamic_cast<CallExpression*>(expr)) {
+			if (!pushArguments(callExpr, true)) {
+				return JitType::Invalid;
+			}
+
+			a.call(bodyLabel);
+			if (arity > 0) {
+				a.addRsp(static_cast<int32_t>(8 * arity));
+			}
+			return returnType;
+		}
+
+		return JitType::Invalid;
+	}
+
+	JitType compileInfix(InfixExpression* infixExpr) {
+		JitType left = compileExpression(infixExpr->left.get());
+		if (!isValue(left)) {
+			return JitType::Invalid;
+		}
+		a.emit({ 0x50 }); // push rax
+
+		JitType right = compileExpression(infixExpr->right.get());
+		if (right != left) {
+			return JitType::Invalid;
+		}
+		a.emit({ 0x48, 0x89, 0xC1 }); // mov rcx, rax
+		a.emit({ 0x58 });             // pop rax
+
+		Operator op = infixExpr->op;
+
+		if (left == JitType::Int) {
+			switch (op) {
+			case Operator::Plus:
+				a.emit({ 0x48, 0x01, 0xC8 }); // add rax, rcx
+				return JitType::Int;
+			case Operator::Minus:
+				a.emit({ 0x48, 0x29, 0xC8 }); // sub rax, rcx
+				return JitType::Int;
+			case Operator::Asterisk:
+				a.emit({ 0x48, 0x0F, 0xAF, 0xC1 }); // imul rax, rcx
+				return JitType::Int;
+			case Operator::Slash:
+				compileDivision();
+				return JitType::Int;
+			case Operator::Lt:
+				return compileComparison(0x9C); // setl
+			case Operator::Gt:
+				return compileComparison(0x9F); // setg
+			default:
+				break;
+			}
+		}
+
+		switch (op) {
+		case Operator::Eq:
+			return compileComparison(0x94); // sete
+		case Operator::NotEq:
+			return compileComparison(0x95); // setne
+		default:
+			return JitType::Invalid;
+		}
+	}
+
+	JitType compileComparison(uint8_t setcc) {
+		a.emit({ 0x48, 0x39, 0xC8 });       // cmp rax, rcx
+		a.emit({ 0x0F, setcc, 0xC0 });      // setcc al
+		a.emit({ 0x48, 0x0F, 0xB6, 0xC0 }); // movzx rax, al
+		return JitType::Bool;
+	}
+
+	void compileDivision() {
+		size_t divideLabel = a.label();
+		size_t doneLabel = a.label();
+
+		// dividing by zero is an Error, which only the interpreter makes
+		a.emit({ 0x48, 0x85, 0xC9 });       // test rcx, rcx
+		a.jcc(0x84, bailLabel);             // je bail
+
+		// idiv traps on INT64_MIN / -1; negating wraps to INT64_MIN, as wrappingDivide does
+		a.emit({ 0x48, 0x83, 0xF9, 0xFF }); // cmp rcx, -1
+		a.jcc(0x85, divideLabel);           // jne divide
+		a.emit({ 0x48, 0xF7, 0xD8 });       // neg rax
+		a.jmp(doneLabel);
+
+		a.bind(divideLabel);
+		a.emit({ 0x48, 0x99 });             // cqo
+		a.emit({ 0x48, 0xF7, 0xF9 });       // idiv rcx
+		a.bind(doneLabel);
+	}
+
+	// pushes the arguments of a self call, the last one first when reversed (so the first
+	// ends up at the lowest address, where the callee's parameters start)
+	bool pushArguments(CallExpression* callExpr, bool reversed) {
+		auto* callee = dynamic_cast<Identifier*>(callExpr->function.get());
+		if (!callee || callee->value != selfName || slots.count(selfName)
+			|| callExpr->arguments.size() != arity) {
+			return false;
+		}
+
+		// the body has no side effects, so the order arguments are evaluated in can't be observed
+		for (size_t n = 0; n < arity; n++) {
+			size_t i = reversed ? arity - 1 - n : n;
+			if (compileExpression(callExpr->arguments[i].get()) != JitType::Int) {
+				return false;
+			}
+			a.emit({ 0x50 }); // push rax
+		}
+
+		return true;
+	}
+};
+
+// function, or another closure of the same literal over the same scope, is what name finds
+// from where function was defined
+bool findsItself(Function* function, const std::string& name) {
+	ObjectRef found = function->env ? function->env->getObject(name).first : nullptr;
+	if (!found || found->kind() != ObjectKind::Function) {
+		return false;
+	}
+
+	Function* callee = static_cast<Function*>(found.get());
+	return callee->body == function->body && callee->env == function->env;
+}
+
+// the one name the body calls functions by, "" when it calls none; false when it calls
+// several, or something that isn't a name
+bool findSelfName(Function* function, std::string& selfName) {
+	std::unordered_set<std::string> callees;
+	bool simple = true;
+
+	forEachNode(function->body, [&](Node* node) {
+		if (auto* callExpr = dynamic_cast<CallExpression*>(node)) {
+			if (auto* callee = dynamic_cast<Identifier*>(callExpr->function.get())) {
+				callees.insert(callee->value);
+			}
+			else {
+				simple = false;
+			}
+		}
+	});
+
+	if (!simple || callees.size() > 1) {
+		return false;
+	}
+
+	selfName = callees.empty() ? "" : *callees.begin();
+	return true;
+}
+
+#ifdef MONKEY_JIT
+// how profiles should call the function: the name it's bound to where it was defined
+std::string profileName(Function* function, const std::string& selfName) {
+	std::string name = selfName;
+	if (name.empty() && function->env) {
+		for (const auto& [binding, value] : function->env->store) {
+			// a recursive closure finds itself through the upvalue it captured
+			const Object* bound = kindOf(value.get()) == ObjectKind::Upvalue ? static_cast<Upvalue*>(value.get())->value.get() : value.get();
+			if (bound == function) {
+				name = symbolName(binding);
+				break;
+			}
+		}
+	}
+
+	name = "monkey::" + (name.empty() ? std::string("fn") : name) + "(";
+	for (size_t i = 0; i < function->parameters.size(); i++) {
+		name += (i ? ", " : "") + function->parameters[i]->value;
+	}
+	return name + ")";
+}
+
+void writePerfMap(const uint8_t* code, size_t size, const std::string& name) {
+	std::string path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+	if (FILE* map = std::fopen(path.c_str(), "a")) {
+		std::fprintf(map, "%lx %zx %s\n", reinterpret_cast<unsigned long>(code), size, name.c_str());
+		std::fclose(map);
+	}
+}
+#endif
+
+}
+
+std::shared_ptr<JitCode> JitCode::compile(Function* function, const JitConfig& config) {
+#ifdef MONKEY_JIT
+	std::string selfName;
+	if (!function->body || function->parameters.size() > maxArity || !findSelfName(function, selfName)) {
+		return nullptr;
+	}
+
+	// the only calls compiled are calls to the function itself
+	if (!selfName.empty() && !findsItself(function, selfName)) {
+		return nullptr;
+	}
+
+	// a self call's type is the function's, so try each result type in turn
+	for (JitType returnType : { JitType::Int, JitType::Bool }) {
+		BodyCompiler compiler(function, selfName, returnType);
+		if (!compiler.compile()) {
+			continue;
+		}
+
+		const std::vector<uint8_t>& bytes = compiler.code();
+		size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		size_t mapped = (bytes.size() + page - 1) / page * page;
+
+		// written while writable, then made executable and never writable again
+		void* memory = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED) {
+			return nullptr;
+		}
+		std::memcpy(memory, bytes.data(), bytes.size());
+		if (mprotect(memory, mapped, PROT_READ | PROT_EXEC) != 0) {
+			munmap(memory, mapped);
+			return nullptr;
+		}
+
+		std::shared_ptr<JitCode> code(new JitCode());
+		code->memory = static_cast<uint8_t*>(memory);
+		code->length = bytes.size();
+		code->mapped = mapped;
+		code->entry = reinterpret_cast<Entry>(memory);
+		code->arity = function->parameters.size();
+		code->returnsBoolean = returnType == JitType::Bool;
+		code->selfName = selfName;
+
+		if (config.perfMap) {
+			writePerfMap(code->memory, code->length, profileName(function, selfName));
+		}
+
+		return code;
+	}
+#endif
+
+	return nullptr;
+}
+
+JitCode::~JitCode() {
+#ifdef MONKEY_JIT
+	if (memory) {
+		munmap(memory, mapped);
+	}
+#endif
+}
+
+ObjectRef JitCode::call(Function* function, Arguments args, const JitConfig& config) {
+	if (args.size() != arity) {
+		return nullptr;
+	}
+
+	// type guards: parameters are compiled as integers
+	int64_t values[maxArity];
+	for (size_t i = 0; i < arity; i++) {
+		Object* arg = args[i].get();
+		if (!arg || arg->kind() != ObjectKind::Integer) {
+			return nullptr;
+		}
+		values[i] = static_cast<Integer*>(arg)->value;
+	}
+
+	// self calls are compiled as calls to this same code, which holds as long as the name
+	// still finds this function
+	if (!selfName.empty() && !findsItself(function, selfName)) {
+		return nullptr;
+	}
+
+	int64_t bailed = 0;
+	int64_t result = entry(values, &bailed, static_cast<int64_t>(config.maxDepth));
+	if (bailed) {
+		return nullptr;
+	}
+
+	Heap* heap = function->env ? function->env->heap : nullptr;
+	if (returnsBoolean) {
+		return newObject<Boolean>(heap, result != 0);
+	}
+
+	return newObject<Integer>(heap, result);
+}
+
+ObjectRef jitCall(Function* function, Arguments args, const JitConfig& config) {
+	JitState& jit = function->body->jit;
+
+	switch (jit.state) {
+	case JitState::State::Rejected:
+		return nullptr;
+	case JitState::State::Counting:
+		if (++jit.calls < config.threshold) {
+			return nullptr;
+		}
+
+		jit.code = JitCode::compile(function, config);
+		if (!jit.code) {
+			jit.state = JitState::State::Rejected;
+			jitStats.rejected++;
+			return nullptr;
+		}
+
+		jit.state = JitState::State::Compiled;
+		jit.calls = 0;
+		jitStats.compiled++;
+		break;
+	case JitState::State::Compiled:
+		break;
+	}
+
+	ObjectRef result = jit.code->call(function, args, config);
+	if (result) {
+		jitStats.nativeCalls++;
+		return result;
+	}
+
+	// calls counts the bailouts from here on; a body that keeps giving up is interpreted for good
+	jitStats.bailouts++;
+	if (++jit.calls >= maxBailouts) {
+		jit.state = JitState::State::Rejected;
+		jit.code = nullptr;
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <memory>
+#include <vector>
+#include <unistd.h>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "jit.hpp"
+#include "test_helpers.hpp"
+
+// ====== HELPER FUNCTIONS ======
+
+static std::string evalWithJit(const std::string& input, bool enabled) {
+    GcConfig config;
+    config.jit.enabled = enabled;
+    config.jit.threshold = 2;
+    config.jit.maxDepth = 100;
+    return evaluated(input, config);
+}
+
+// the JIT state of the last function literal in program after running it
+static JitState::State jitStateAfter(const std::string& input) {
+    GcConfig config;
+    config.jit.enabled = true;
+    config.jit.threshold = 2;
+
+    std::unique_ptr<Program> program = parse(input);
+    Heap heap(config);
+    eval(program.get(), heap.newEnvironment(nullptr));
+
+    JitState::State state = JitState::State::Counting;
+    forEachNode(program.get(), [&state](Node* node) {
+        if (auto* funcLit = dynamic_cast<FunctionLiteral*>(node)) {
+            state = funcLit->body->jit.state;
+        }
+    });
+
+    return state;
+}
+
+// ====== TEST FUNCTIONS ======
+
+static void TestJitMatchesEval() {
+    std::vector<std::string> inputs = {
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } }; fib(20)",
+        "let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1, acc + 2) } }; loop(100000, 0)",
+        "let even = fn(n) { if (n == 0) { true } else { !even(n - 1) } }; even(10) == !even(7)",
+        "let f = fn(x, y) { let s = x * y; let d = s / 3 - -x; if (d > 10) { return d; } d * 2 }; f(1, 2) + f(5, 7) + f(-4, 9)",
+        "let f = fn(x) { 100 / x }; f(5); f(4); f(0)",
+        "let f = fn(x) { x + 1 }; f(1); f(2); f(true)",
+        "let sum = fn(n) { if (n == 0) { 0 } else { n + sum(n - 1) } }; sum(10) + sum(500)",
+        "let f = fn(x) { if (x > 0) { f(x - 1) } }; f(3); f(2); f(1)",
+        "let g = fn(n) { if (n < 1) { 0 } else { g(n - 1) } }; g(5); g(5); let h = g; let g = fn(n) { 42 }; h(3)",
+        "let f = fn(x) { let y = if (x > 1) { return 7; } else { 3 }; y + 1 }; f(1); f(2); f(3)",
+    };
+
+    for (const auto& input : inputs) {
+        std::string expected = evalWithJit(input, false);
+        std::string got = evalWithJit(input, true);
+
+        if (expected != got) {
+            std::cerr << "JIT result differs for \"" << input << "\". expected="
+                      << expected << ", got=" << got << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestJitMatchesEval passed!\n";
+}
+
+static void TestJitOnlyCompilesIntegerCode() {
+    struct Case {
+        std::string input;
+        JitState::State expected;
+    };
+
+    std::vector<Case> cases = {
+        { "let f = fn(x) { x * 2 }; f(1); f(2); f(3)", JitState::State::Compiled },
+        { "let f = fn(x) { x < 2 }; f(1); f(2); f(3)", JitState::State::Compiled },
+        { "let f = fn(x) { \"a\" }; f(1); f(2); f(3)", JitState::State::Rejected },
+        { "let k = 3; let f = fn(x) { x * k }; f(1); f(2); f(3)", JitState::State::Rejected },
+        { "let g = fn(x) { x }; let f = fn(x) { g(x) }; f(1); f(2); f(3)", JitState::State::Rejected },
+        { "let f = fn(x) { if (x > 1) { 1 } }; f(1); f(2); f(3)", JitState::State::Rejected },
+        { "let f = fn(x) { let y = 1; }; f(1); f(2); f(3)", JitState::State::Rejected },
+        { "let f = fn(x) { x }; f(1)", JitState::State::Counting },
+    };
+
+    for (const auto& c : cases) {
+        JitState::State state = jitStateAfter(c.input);
+        if (state != c.expected) {
+            std::cerr << "wrong JIT state for \"" << c.input << "\". expected=" << static_cast<int>(c.expected)
+                      << ", got=" << static_cast<int>(state) << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestJitOnlyCompilesIntegerCode passed!\n";
+}
+
+static void TestJitWritesPerfMap() {
+    size_t compiled = jitStats.compiled;
+    jitStateAfter("let square = fn(side) { side * side }; square(1); square(2); square(3)");
+
+    if (jitStats.compiled != compiled + 1) {
+        std::cerr << "square was not compiled\n";
+        return;
+    }
+
+    std::ifstream map("/tmp/perf-" + std::to_string(getpid()) + ".map");
+    std::string line;
+    bool found = false;
+    while (std::getline(map, line)) {
+        if (line.find(" monkey::square(side)") != std::string::npos) {
+            found = true;
+        }
+    }
+
+    if (!found) {
+        std::cerr << "no perf map entry for square\n";
+        return;
+    }
+
+    std::cout << "TestJitWritesPerfMap passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestJitMatchesEval();
+//    TestJitOnlyCompilesIntegerCode();
+//    TestJitWritesPerfMap();
+//    return 0;
+//}
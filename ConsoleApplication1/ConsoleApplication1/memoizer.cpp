@@ -0,0 +1,162 @@
+#include "memoizer.hpp"
+#include "gc.hpp"
+
+thread_local MemoStats memoStats;
+
+// values with no identity of their own, so a recorded one is as good as a fresh one
+static bool isPlainValue(Object* obj) {
+	switch (obj->kind()) {
+	case ObjectKind::Integer:
+	case ObjectKind::Boolean:
+	case ObjectKind::String:
+	case ObjectKind::Null:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// appends obj to key so that different values never encode the same way
+static void encode(std::string& key, Object* obj) {
+	key.push_back(static_cast<char>(obj->kind()));
+
+	switch (obj->kind()) {
+	case ObjectKind::Integer: {
+		int64_t value = static_cast<Integer*>(obj)->value;
+		key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+		break;
+	}
+	case ObjectKind::Boolean:
+		key.push_back(static_cast<Boolean*>(obj)->value ? 1 : 0);
+		break;
+	case ObjectKind::String: {
+		const std::string& value = static_cast<String*>(obj)->value;
+		uint64_t length = value.size();
+		key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+		key.append(value);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+bool isPure(BlockStatement* body) {
+	if (body->purity == Purity::Unknown) {
+		bool createsFunctions = false;
+		forEachNode(body, [&createsFunctions](Node* node) {
+			if (dynamic_cast<FunctionLiteral*>(node)) {
+				createsFunctions = true;
+			}
+		});
+
+		body->purity = createsFunctions ? Purity::Impure : Purity::Pure;
+	}
+
+	return body->purity == Purity::Pure;
+}
+
+void MemoTable::flushIfStale() {
+	if (scope && rebinds != scope->rebinds) {
+		if (!order.empty()) {
+			memoStats.flushes++;
+		}
+
+		order.clear();
+		entries.clear();
+		rebinds = scope->rebinds;
+	}
+}
+
+ObjectRef MemoTable::find(const std::string& key) {
+	flushIfStale();
+
+	auto entry = entries.find(key);
+	if (entry == entries.end()) {
+		return nullptr;
+	}
+
+	order.splice(order.begin(), order, entry->second);
+	return entry->second->second;
+}
+
+void MemoTable::insert(const std::string& key, ObjectRef value, size_t maxEntries) {
+	flushIfStale();
+
+	auto entry = entries.find(key);
+	if (entry != entries.end()) {
+		entry->second->second = std::move(value);
+		order.splice(order.begin(), order, entry->second);
+		return;
+	}
+
+	order.emplace_front(key, std::move(value));
+	entries[key] = order.begin();
+
+	while (order.size() > maxEntries) {
+		entries.erase(order.back().first);
+		order.pop_back();
+		memoStats.evictions++;
+	}
+}
+
+MemoizedCall memoizedCall(const ObjectRef& fn, Arguments args) {
+	MemoizedCall call;
+
+	if (!fn || fn->kind() != ObjectKind::Function) {
+		return call;
+	}
+
+	Function* function = static_cast<Function*>(fn.get());
+	if (!function->body || !function->env || function->env->outer || args.size() != function->parameters.size()
+		|| !isPure(function->body)) {
+		return call;
+	}
+
+	for (const ObjectRef& arg : args) {
+		if (!arg || !isPlainValue(arg.get())) {
+			return call;
+		}
+		encode(call.key, arg.get());
+	}
+
+	call.function = fn;
+	return call;
+}
+
+ObjectRef memoLookup(const MemoizedCall& call) {
+	Function* function = static_cast<Function*>(call.function.get());
+
+	ObjectRef result = function->memo ? function->memo->find(call.key) : nullptr;
+	if (result) {
+		memoStats.hits++;
+	}
+	else {
+		memoStats.misses++;
+	}
+
+	return result;
+}
+
+void memoStore(const MemoizedCall& call, const ObjectRef& result, const MemoConfig& config) {
+	if (!result || !isPlainValue(result.get())) {
+		return;
+	}
+
+	Function* function = static_cast<Function*>(call.function.get());
+	if (!function->memo) {
+		function->memo = std::make_shared<MemoTable>(function->env.get());
+	}
+
+	// the table outlives the expression that made the result
+	Heap* heap = function->env->heap;
+	function->memo->insert(call.key, heap ? heap->promote(result) : result, config.maxEntries);
+}
+
+void printMemoStats(std::ostream& out, const MemoStats& stats) {
+	size_t calls = stats.hits + stats.misses;
+	double percent = calls ? 100.0 * stats.hits / calls : 0.0;
+	out << "memoized calls: " << stats.hits << " hits, " << stats.misses << " misses ("
+		<< static_cast<int>(percent + 0.5) << "% hit rate), " << stats.evictions << " evictions, "
+		<< stats.flushes << " flushes\n";
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "memoizer.hpp"
+#include "test_helpers.hpp"
+
+// ====== TEST FUNCTIONS ======
+
+static void TestPurity() {
+    std::vector<std::pair<std::string, bool>> tests = {
+        {"fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } }", true},
+        {"fn(a, b) { let c = a * b; c + k }", true},
+        {"fn(s) { s + \"!\" }", true},
+        {"fn(x) { fn(y) { x + y } }", false},
+        {"fn(x) { let f = fn(y) { y }; f(x) }", false},
+    };
+
+    for (const auto& [input, expected] : tests) {
+        std::unique_ptr<Program> program = parse(input);
+        auto* funcLit = static_cast<FunctionLiteral*>(
+            static_cast<ExpressionStatement*>(program->statements[0].get())->value.get());
+
+        if (isPure(funcLit->body.get()) != expected) {
+            std::cerr << "wrong purity for \"" << input << "\". expected=" << expected << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestPurity passed!\n";
+}
+
+static void TestMemoizedEvalMatchesEval() {
+    std::vector<std::string> inputs = {
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } }; fib(20)",
+        "let k = 3; let f = fn(a) { a * k }; f(2) + f(2)",
+        "let f = fn(a) { a / 0 }; f(1); f(1)",
+        "let f = fn(a) { a + missing }; f(1)",
+        R"(let greet = fn(s) { s + "!" }; greet("a") + greet("a"))",
+        "let add = fn(a) { fn(b) { a + b } }; add(1)(2) + add(1)(3)",
+        "let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1, acc + n) } }; loop(1000, 0) + loop(1000, 0)",
+        "let f = fn(a) { if (a) { 1 } }; f(false)",
+        "let outer = fn() { let g = fn(x) { x * 2 }; g(2) + g(2) }; outer()",
+    };
+
+    for (const auto& input : inputs) {
+        std::string expected = evaluated(input, &GcConfig::memo, false);
+        std::string got = evaluated(input, &GcConfig::memo, true);
+
+        if (expected != got) {
+            std::cerr << "memoized result differs for \"" << input << "\". expected=" << expected
+                      << ", got=" << got << "\n";
+            return;
+        }
+    }
+
+    // binding a global name again empties the tables of the functions that may look it up
+    GcConfig config;
+    config.memo.enabled = true;
+    Heap heap(config);
+    auto env = heap.newEnvironment(nullptr);
+    std::unique_ptr<Program> first = parse("let k = 3; let f = fn(a) { a * k }; f(2)");
+    std::unique_ptr<Program> second = parse("let k = 10; f(2)");
+    std::string before = describe(eval(first.get(), env).get());
+    std::string after = describe(eval(second.get(), env).get());
+
+    if (before != "INTEGER 6" || after != "INTEGER 20") {
+        std::cerr << "memoized result outlived a rebinding. got=" << before << ", " << after << "\n";
+        return;
+    }
+
+    std::cout << "TestMemoizedEvalMatchesEval passed!\n";
+}
+
+static void TestMemoizedRecursionIsLinear() {
+    MemoStats before = memoStats;
+    std::string result = evaluated("let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } }; fib(60)", &GcConfig::memo, true);
+
+    // fib(60) down to fib(0) each miss once, and fib(n - 2) is found for every n from 60 to 3
+    size_t hits = memoStats.hits - before.hits;
+    size_t misses = memoStats.misses - before.misses;
+    if (result != "INTEGER 1548008755920" || misses != 61 || hits != 58) {
+        std::cerr << "wrong memoization of fib. result=" << result << ", hits=" << hits << ", misses=" << misses << "\n";
+        return;
+    }
+
+    std::cout << "TestMemoizedRecursionIsLinear passed!\n";
+}
+
+static void TestMemoEviction() {
+    MemoStats before = memoStats;
+
+    MemoTable table;
+    table.insert("a", makeRef<Integer>(1), 2);
+    table.insert("b", makeRef<Integer>(2), 2);
+    table.find("a");                                 // b is now the least recently used
+    table.insert("c", makeRef<Integer>(3), 2);
+
+    bool kept = table.find("a") && table.find("c") && !table.find("b") && table.size() == 2;
+    size_t evictions = memoStats.evictions - before.evictions;
+
+    if (!kept || evictions != 1) {
+        std::cerr << "wrong eviction. evictions=" << evictions << "\n";
+        return;
+    }
+
+    std::cout << "TestMemoEviction passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestPurity();
+//    TestMemoizedEvalMatchesEval();
+//    TestMemoizedRecursionIsLinear();
+//    TestMemoEviction();
+//    return 0;
+//}
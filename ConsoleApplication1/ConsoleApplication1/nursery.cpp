@@ -0,0 +1,84 @@
+#include <algorithm>
+#include "nursery.hpp"
+
+static size_t alignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+Nursery::~Nursery() {
+	for (Chunk* chunk : chunks) {
+		if (chunk->live == 0) {
+			freeChunk(chunk);
+		}
+		else {
+			// objects that outlive the interpreter release the chunk themselves
+			chunk->owner = nullptr;
+		}
+	}
+}
+
+void* Nursery::allocateSlow(size_t bytes, size_t alignment) {
+	size_t headerSize = alignUp(sizeof(Chunk), alignof(std::max_align_t));
+	if (headerSize + bytes > chunkSize) {
+		throw std::bad_alloc();
+	}
+
+	// the chunk is full: reuse it in place if everything in it already died,
+	// otherwise leave it to be recycled by its last release()
+	if (current && current->live == 0) {
+		current->used = headerSize;
+		nurseryStats.chunksRecycled++;
+	}
+	else {
+		current = takeChunk();
+	}
+
+	return allocate(bytes, alignment);
+}
+
+void Nursery::chunkEmptied(Chunk* chunk) {
+	if (!chunk->owner) {
+		freeChunk(chunk);
+	}
+	else if (chunk != chunk->owner->current) {
+		chunk->owner->recycle(chunk);
+	}
+}
+
+Nursery::Chunk* Nursery::takeChunk() {
+	if (!freeChunks.empty()) {
+		Chunk* chunk = freeChunks.back();
+		freeChunks.pop_back();
+		nurseryStats.chunksRecycled++;
+		return chunk;
+	}
+
+	void* memory = ::operator new(chunkSize, std::align_val_t(chunkSize));
+	Chunk* chunk = new (memory) Chunk{ this, quota, alignUp(sizeof(Chunk), alignof(std::max_align_t)), 0 };
+	if (quota) {
+		quota->charge(chunkSize);
+	}
+	chunks.push_back(chunk);
+	nurseryStats.chunksAllocated++;
+	return chunk;
+}
+
+void Nursery::recycle(Chunk* chunk) {
+	chunk->used = alignUp(sizeof(Chunk), alignof(std::max_align_t));
+
+	if (freeChunks.size() < maxFreeChunks) {
+		freeChunks.push_back(chunk);
+		return;
+	}
+
+	chunks.erase(std::find(chunks.begin(), chunks.end(), chunk));
+	freeChunk(chunk);
+}
+
+void Nursery::freeChunk(Chunk* chunk) {
+	if (chunk->quota) {
+		chunk->quota->credit(chunkSize);
+	}
+	chunk->~Chunk();
+	::operator delete(static_cast<void*>(chunk), std::align_val_t(chunkSize));
+}
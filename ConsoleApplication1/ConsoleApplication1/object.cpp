@@ -0,0 +1,238 @@
+#include <atomic>
+#include "object.hpp"
+#include "gc.hpp"
+#include "frames.hpp"
+
+Bindings::Inserted Bindings::insert(Symbol symbol) {
+	if (ObjectRef* value = find(symbol)) {
+		return { value, false, false };
+	}
+
+	if (!table && count < inlineCapacity) {
+		small[count].symbol = symbol;
+		return { &small[count++].value, true, false };
+	}
+
+	bool moved = false;
+	if (!table || (count + 1) * 4 > capacity * 3) {
+		grow();
+		moved = true;
+	}
+
+	Entry& entry = slot(symbol);
+	entry.symbol = symbol;
+	count++;
+	return { &entry.value, true, moved };
+}
+
+void Bindings::grow() {
+	size_t oldCapacity = capacity;
+	std::unique_ptr<Entry[]> old = std::move(table);
+
+	capacity = old ? oldCapacity * 2 : 16;
+	table = std::make_unique<Entry[]>(capacity);
+
+	Entry* from = old ? old.get() : small;
+	for (size_t i = 0, n = old ? oldCapacity : count; i < n; i++) {
+		if (from[i].symbol != noSymbol) {
+			slot(from[i].symbol) = std::move(from[i]);
+		}
+	}
+
+	if (!old) {
+		for (Entry& entry : small) {
+			entry = Entry();
+		}
+	}
+}
+
+void Bindings::clear() {
+	for (size_t i = 0; i < count && !table; i++) {
+		small[i] = Entry();
+	}
+
+	table.reset();
+	capacity = 0;
+	count = 0;
+}
+
+ObjectRef Environment::setObject(Symbol symbol, ObjectRef val) {
+	// a value bound in an environment that outlives the call survives its expression,
+	// so it moves out of the nursery instead of pinning a nursery chunk
+	if (heap && captured) {
+		val = heap->promote(std::move(val));
+	}
+
+	auto [entry, inserted, moved] = store.insert(symbol);
+	if (moved) {
+		// identifier caches point at entries
+		serial = nextSerial();
+	}
+
+	if (!inserted && kindOf(entry->get()) == ObjectKind::Upvalue) {
+		// the closures sharing the binding see the new value; they outlive this call
+		static_cast<Upvalue*>(entry->get())->value = heap ? heap->promote(val) : val;
+		return val;
+	}
+
+	if (!inserted && !outer) {
+		rebinds++;
+	}
+
+	*entry = val;
+	nameMask |= symbolBit(symbol);
+	return val;
+}
+
+Ref<Upvalue> Environment::upvalue(Symbol symbol) {
+	auto [entry, inserted, moved] = store.insert(symbol);
+	if (!inserted && kindOf(entry->get()) == ObjectKind::Upvalue) {
+		return staticRefCast<Upvalue>(*entry);
+	}
+
+	ObjectRef value = std::move(*entry);
+	if (heap) {
+		value = heap->promote(std::move(value));
+	}
+
+	Ref<Upvalue> box = heap ? heap->allocateOld<Upvalue>(std::move(value)) : makeRef<Upvalue>(std::move(value));
+	*entry = box;
+	nameMask |= symbolBit(symbol);
+	serial = nextSerial(); // identifier caches point at the entry, which now holds the upvalue
+	return box;
+}
+
+Environment::~Environment() {
+	if (trackedAt != untracked) {
+		heap->untrack(this);
+	}
+}
+
+void Environment::reclaim() {
+	if (stacked) {
+		Heap* owner = heap;
+		this->~Environment();
+		frameStackOf(owner).release(this);
+		if (owner) {
+			owner->quota().credit(sizeof(Environment));
+		}
+		return;
+	}
+
+	delete this;
+}
+
+void Environment::reset(EnvironmentRef out) {
+	store.clear();
+	outer = std::move(out);
+	captured = false;
+	nameMask = 0;
+	serial = nextSerial(); // identifier caches may still point at the old entries
+}
+
+uint64_t Environment::nextSerial() {
+	static std::atomic<uint64_t> serials{ 1 };
+	return serials.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Object::reclaim() {
+	if (young) {
+		this->~Object();
+		Nursery::release(this);
+		return;
+	}
+
+	delete this;
+}
+
+// an old-space copy of value, nullptr when it can't be copied
+static Object* copyValue(const Object* value) {
+	switch (kindOf(value)) {
+	case ObjectKind::Integer:
+		return new Integer(static_cast<const Integer*>(value)->value);
+	case ObjectKind::Boolean:
+		return new Boolean(static_cast<const Boolean*>(value)->value);
+	case ObjectKind::String:
+		return new String(static_cast<const String*>(value)->value);
+	case ObjectKind::Null:
+		return new Null();
+	case ObjectKind::Error: {
+		Error* error = new Error(*static_cast<const Error*>(value));
+		error->young = false;
+		return error;
+	}
+	default:
+		return nullptr;
+	}
+}
+
+SharedValue shareValue(const Object* value) {
+	return SharedValue(copyValue(value));
+}
+
+ObjectRef unshareValue(const SharedValue& value) {
+	return ObjectRef(copyValue(value.get()));
+}
+
+const objectType& kindName(ObjectKind kind) {
+	switch (kind) {
+	case ObjectKind::Integer: return objectTypes::INTEGER_OBJ;
+	case ObjectKind::Boolean: return objectTypes::BOOLEAN_OBJ;
+	case ObjectKind::String: return objectTypes::STRING_OBJ;
+	case ObjectKind::ReturnValue: return objectTypes::RETURN_OBJ;
+	case ObjectKind::TailCall: return objectTypes::TAIL_CALL_OBJ;
+	case ObjectKind::Upvalue: return objectTypes::UPVALUE_OBJ;
+	case ObjectKind::Error: return objectTypes::ERROR_OBJ;
+	case ObjectKind::Function: return objectTypes::FUNCTION_OBJ;
+	default: return objectTypes::NULL_OBJ;
+	}
+}
+
+const std::string& Error::message() const {
+	if (formatted) {
+		return text;
+	}
+
+	switch (code) {
+	case ErrorCode::NotAFunction:
+		text = left == ObjectKind::Count ? "not a function: got NULL" : "not a function: " + kindName(left);
+		break;
+	case ErrorCode::IdentifierNotFound:
+		text = "identifier not found: " + name;
+		break;
+	case ErrorCode::UnknownPrefixOperator:
+		text = "Unknown operator : " + operatorLiteral(op) + "; object type : " + kindName(right);
+		break;
+	case ErrorCode::PrefixTypeMismatch:
+		text = "Type missmatch : " + kindName(right);
+		break;
+	case ErrorCode::DivisionByZero:
+		text = "Division by zero";
+		break;
+	case ErrorCode::UnknownIntegerOperator:
+		text = "Unknown operator : " + operatorLiteral(op);
+		break;
+	case ErrorCode::UnknownStringOperator:
+		text = "unknown operator: STRING " + operatorLiteral(op) + " STRING";
+		break;
+	case ErrorCode::OperandMismatch:
+		if (kindName(left) != kindName(right)) {
+			text = "type mismatch: " + kindName(left) + " + " + kindName(right);
+		}
+		else {
+			text = "unknown operator : " + operatorLiteral(op) + "; object types: " + kindName(left) + kindName(right);
+		}
+		break;
+	case ErrorCode::StackDepthExceeded:
+		text = "stack depth exceeded";
+		break;
+	case ErrorCode::MemoryLimitExceeded:
+		text = "memory limit exceeded";
+		break;
+	case ErrorCode::Custom:
+		break;
+	}
+
+	formatted = true;
+	return text;
+}
@@ -0,0 +1,513 @@
+#include <algorithm>
+#include <unordered_map>
+#include "optimizer.hpp"
+#include "evaluator.hpp"
+#include "type_inference.hpp"
+
+namespace {
+
+// @brief walks every statement list and expression slot of a program, children before their
+// parents, so a visit sees subtrees that were already rewritten
+class Rewriter {
+public:
+	virtual ~Rewriter() = default;
+
+	size_t rewrites = 0;
+
+	void walkStatements(std::vector<std::unique_ptr<Statement>>& statements) {
+		for (auto& stmt : statements) {
+			walkStatement(stmt.get());
+		}
+
+		visitStatements(statements);
+	}
+
+	void walkStatement(Statement* stmt) {
+		if (auto* letStmt = dynamic_cast<LetStatement*>(stmt)) {
+			walkExpression(letStmt->value);
+		}
+		else if (auto* returnStmt = dynamic_cast<ReturnStatement*>(stmt)) {
+			walkExpression(returnStmt->value);
+		}
+		else if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(stmt)) {
+			walkExpression(exprStmt->value);
+		}
+		else if (auto* blockStmt = dynamic_cast<BlockStatement*>(stmt)) {
+			walkStatements(blockStmt->statements);
+		}
+	}
+
+	void walkExpression(std::unique_ptr<Expression>& slot) {
+		if (!slot) {
+			return;
+		}
+
+		Expression* expr = slot.get();
+
+		if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+			walkExpression(prefixExpr->right);
+		}
+		else if (auto* infixExpr = dynamic_cast<InfixExpression*>(expr)) {
+			walkExpression(infixExpr->left);
+			walkExpression(infixExpr->right);
+		}
+		else if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			walkExpression(ifExpr->condition);
+			walkStatement(ifExpr->consequence.get());
+			if (ifExpr->alternative) {
+				walkStatement(ifExpr->alternative.get());
+			}
+		}
+		else if (auto* funcLit = dynamic_cast<FunctionLiteral*>(expr)) {
+			walkStatement(funcLit->body.get());
+		}
+		else if (auto* callExpr = dynamic_cast<CallExpression*>(expr)) {
+			walkExpression(callExpr->function);
+			for (auto& arg : callExpr->arguments) {
+				walkExpression(arg);
+			}
+		}
+
+		visitExpression(slot);
+	}
+
+protected:
+	virtual void visitStatements(std::vector<std::unique_ptr<Statement>>&) {};
+	virtual void visitExpression(std::unique_ptr<Expression>&) {};
+};
+
+// value of a literal, nullptr for anything else
+ObjectRef literalValue(Expression* expr) {
+	if (auto* intLit = dynamic_cast<IntegerLiteral*>(expr)) {
+		return makeRef<Integer>(intLit->value);
+	}
+
+	if (auto* boolLit = dynamic_cast<BooleanLiteral*>(expr)) {
+		return makeRef<Boolean>(boolLit->value);
+	}
+
+	if (auto* stringLit = dynamic_cast<StringLiteral*>(expr)) {
+		return makeRef<String>(stringLit->value);
+	}
+
+	return nullptr;
+}
+
+// the literal evaluating to obj, nullptr when there is none (errors, null, functions)
+std::unique_ptr<Expression> toLiteral(Object* obj) {
+	if (auto* intObj = dynamic_cast<Integer*>(obj)) {
+		return std::make_unique<IntegerLiteral>(Token{ TokenTypes::INT, std::to_string(intObj->value) }, intObj->value);
+	}
+
+	if (auto* boolObj = dynamic_cast<Boolean*>(obj)) {
+		Token tok = boolObj->value ? Token{ TokenTypes::TRUE, "true" } : Token{ TokenTypes::FALSE, "false" };
+		return std::make_unique<BooleanLiteral>(tok, boolObj->value);
+	}
+
+	if (auto* stringObj = dynamic_cast<String*>(obj)) {
+		return std::make_unique<StringLiteral>(Token{ TokenTypes::STRING, stringObj->value }, stringObj->value);
+	}
+
+	return nullptr;
+}
+
+class Folder : public Rewriter {
+protected:
+	void visitExpression(std::unique_ptr<Expression>& slot) override {
+		Expression* expr = slot.get();
+
+		// the evaluator's own operators compute the value, so folding can't change a result
+		if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+			ObjectRef right = literalValue(prefixExpr->right.get());
+			if (right) {
+				replace(slot, evalPrefixExpression(prefixExpr->op, std::move(right), nullptr));
+			}
+		}
+		else if (auto* infixExpr = dynamic_cast<InfixExpression*>(expr)) {
+			ObjectRef left = literalValue(infixExpr->left.get());
+			ObjectRef right = literalValue(infixExpr->right.get());
+			if (left && right) {
+				replace(slot, evalInfixExpression(infixExpr->op, std::move(left), std::move(right), nullptr));
+			}
+		}
+		else if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			foldIf(slot, ifExpr);
+		}
+	};
+
+private:
+	void replace(std::unique_ptr<Expression>& slot, ObjectRef value) {
+		std::unique_ptr<Expression> literal = toLiteral(value.get());
+		if (literal) {
+			slot = std::move(literal);
+			rewrites++;
+		}
+	}
+
+	void foldIf(std::unique_ptr<Expression>& slot, IfExpression* ifExpr) {
+		ObjectRef condition = literalValue(ifExpr->condition.get());
+		if (!condition) {
+			return;
+		}
+
+		bool taken = isTruthy(condition.get());
+		std::unique_ptr<BlockStatement>& branch = taken ? ifExpr->consequence : ifExpr->alternative;
+
+		// if (false) { ... } without an else is NULL, which has no literal
+		if (!branch) {
+			return;
+		}
+
+		// a branch that is a single expression becomes that expression
+		if (branch->statements.size() == 1) {
+			if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(branch->statements[0].get())) {
+				if (exprStmt->value) {
+					std::unique_ptr<Expression> hoisted = std::move(exprStmt->value);
+					slot = std::move(hoisted);
+					rewrites++;
+					return;
+				}
+			}
+		}
+
+		// otherwise keep the block (blocks share their environment, so this is only about the branch)
+		if (!taken) {
+			ifExpr->consequence = std::move(ifExpr->alternative);
+			ifExpr->condition = std::make_unique<BooleanLiteral>(Token{ TokenTypes::TRUE, "true" }, true);
+			rewrites++;
+		}
+		else if (ifExpr->alternative) {
+			ifExpr->alternative.reset();
+			rewrites++;
+		}
+	}
+};
+
+class DeadCodeEliminator : public Rewriter {
+protected:
+	void visitStatements(std::vector<std::unique_ptr<Statement>>& statements) override {
+		// nothing after a return runs
+		for (size_t i = 0; i < statements.size(); i++) {
+			if (dynamic_cast<ReturnStatement*>(statements[i].get())) {
+				rewrites += statements.size() - (i + 1);
+				statements.erase(statements.begin() + i + 1, statements.end());
+				break;
+			}
+		}
+
+		// only the last statement's value is kept, the others are just evaluated
+		for (size_t i = 0; i + 1 < statements.size();) {
+			auto* exprStmt = dynamic_cast<ExpressionStatement*>(statements[i].get());
+
+			if (exprStmt && isPure(exprStmt->value.get())) {
+				statements.erase(statements.begin() + i);
+				rewrites++;
+			}
+			else {
+				i++;
+			}
+		}
+	};
+
+private:
+	static bool isPure(Expression* expr) {
+		return literalValue(expr) != nullptr || dynamic_cast<FunctionLiteral*>(expr) != nullptr;
+	}
+};
+
+// @brief finds let-bound helpers small enough to inline and expands the calls to them
+class Inliner {
+public:
+	std::vector<std::string>& sites;
+
+	explicit Inliner(std::vector<std::string>& sites) : sites(sites) {}
+
+	void findHelpers(Program& program) {
+		std::unordered_map<std::string, size_t> bindings;
+		std::unordered_map<std::string, FunctionLiteral*> literals;
+
+		forEachNode(&program, [&](Node* node) {
+			if (auto* letStmt = dynamic_cast<LetStatement*>(node)) {
+				bindings[letStmt->name->value]++;
+				if (auto* funcLit = dynamic_cast<FunctionLiteral*>(letStmt->value.get())) {
+					literals[letStmt->name->value] = funcLit;
+				}
+			}
+		});
+
+		// a name bound more than once could mean either function at a given call
+		for (const auto& [name, funcLit] : literals) {
+			Expression* body = helperBody(funcLit);
+			if (bindings[name] == 1 && body) {
+				helpers[name] = { funcLit, body };
+			}
+		}
+	}
+
+	void walkStatements(std::vector<std::unique_ptr<Statement>>& statements) {
+		size_t scopeSize = bound.size();
+
+		for (auto& stmt : statements) {
+			if (auto* letStmt = dynamic_cast<LetStatement*>(stmt.get())) {
+				walkExpression(letStmt->value.get());
+				bound.push_back(letStmt->name->value);
+			}
+			else if (auto* returnStmt = dynamic_cast<ReturnStatement*>(stmt.get())) {
+				walkExpression(returnStmt->value.get());
+			}
+			else if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(stmt.get())) {
+				walkExpression(exprStmt->value.get());
+			}
+		}
+
+		// lets in a branch only bind their name if the branch runs, so they are forgotten after it
+		bound.resize(scopeSize);
+	}
+
+private:
+	struct Helper {
+		FunctionLiteral* literal;
+		Expression* body;
+	};
+
+	std::unordered_map<std::string, Helper> helpers;
+	std::vector<std::string> bound; // names that certainly have a binding at the current point
+
+	// the expression a helper returns, nullptr when it isn't small and closed
+	static Expression* helperBody(FunctionLiteral* funcLit) {
+		if (!funcLit->body || funcLit->body->statements.size() != 1) {
+			return nullptr;
+		}
+
+		Statement* stmt = funcLit->body->statements[0].get();
+		Expression* body = nullptr;
+		if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(stmt)) {
+			body = exprStmt->value.get();
+		}
+		else if (auto* returnStmt = dynamic_cast<ReturnStatement*>(stmt)) {
+			body = returnStmt->value.get();
+		}
+
+		if (!body || countNodes(body) > FunctionInlining::maxBodyNodes) {
+			return nullptr;
+		}
+
+		std::vector<std::string> parameters;
+		for (const auto& param : funcLit->parameters) {
+			if (std::find(parameters.begin(), parameters.end(), param->value) != parameters.end()) {
+				return nullptr;
+			}
+			parameters.push_back(param->value);
+		}
+
+		bool closed = true;
+		forEachNode(body, [&](Node* node) {
+			if (auto* ident = dynamic_cast<Identifier*>(node)) {
+				if (std::find(parameters.begin(), parameters.end(), ident->value) == parameters.end()) {
+					closed = false;
+				}
+			}
+			else if (!dynamic_cast<IntegerLiteral*>(node) && !dynamic_cast<BooleanLiteral*>(node)
+				&& !dynamic_cast<StringLiteral*>(node) && !dynamic_cast<PrefixExpression*>(node)
+				&& !dynamic_cast<InfixExpression*>(node)) {
+				closed = false;
+			}
+		});
+
+		return closed ? body : nullptr;
+	}
+
+	void walkExpression(Expression* expr) {
+		if (!expr) {
+			return;
+		}
+
+		if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+			walkExpression(prefixExpr->right.get());
+		}
+		else if (auto* infixExpr = dynamic_cast<InfixExpression*>(expr)) {
+			walkExpression(infixExpr->left.get());
+			walkExpression(infixExpr->right.get());
+		}
+		else if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			walkExpression(ifExpr->condition.get());
+			walkStatements(ifExpr->consequence->statements);
+			if (ifExpr->alternative) {
+				walkStatements(ifExpr->alternative->statements);
+			}
+		}
+		else if (auto* funcLit = dynamic_cast<FunctionLiteral*>(expr)) {
+			size_t scopeSize = bound.size();
+			for (const auto& param : funcLit->parameters) {
+				bound.push_back(param->value);
+			}
+			if (funcLit->body) {
+				walkStatements(funcLit->body->statements);
+			}
+			bound.resize(scopeSize);
+		}
+		else if (auto* callExpr = dynamic_cast<CallExpression*>(expr)) {
+			walkExpression(callExpr->function.get());
+			for (const auto& arg : callExpr->arguments) {
+				walkExpression(arg.get());
+			}
+			inlineCall(callExpr);
+		}
+	}
+
+	// literals, and names that can't fail to resolve, are safe to evaluate any number of times in any order
+	bool isTrivial(Expression* arg) const {
+		if (dynamic_cast<IntegerLiteral*>(arg) || dynamic_cast<BooleanLiteral*>(arg) || dynamic_cast<StringLiteral*>(arg)) {
+			return true;
+		}
+
+		auto* ident = dynamic_cast<Identifier*>(arg);
+		return ident && std::find(bound.begin(), bound.end(), ident->value) != bound.end();
+	}
+
+	void inlineCall(CallExpression* callExpr) {
+		auto* callee = dynamic_cast<Identifier*>(callExpr->function.get());
+		if (!callee) {
+			return;
+		}
+
+		auto helper = helpers.find(callee->value);
+		if (helper == helpers.end() || helper->second.literal->parameters.size() != callExpr->arguments.size()) {
+			return;
+		}
+
+		std::unordered_map<std::string, Expression*> arguments;
+		for (size_t i = 0; i < callExpr->arguments.size(); i++) {
+			if (!isTrivial(callExpr->arguments[i].get())) {
+				return;
+			}
+			arguments[helper->second.literal->parameters[i]->value] = callExpr->arguments[i].get();
+		}
+
+		callExpr->inlined = substitute(helper->second.body, arguments);
+		callExpr->inlinedFrom = helper->second.literal->code->serial;
+		sites.push_back(callExpr->string() + " -> " + callExpr->inlined->string());
+	}
+
+	// a copy of expr (made of literals, names, prefix and infix expressions) with parameters replaced
+	static std::unique_ptr<Expression> substitute(Expression* expr, const std::unordered_map<std::string, Expression*>& arguments) {
+		if (auto* ident = dynamic_cast<Identifier*>(expr)) {
+			auto arg = arguments.find(ident->value);
+			if (arg != arguments.end()) {
+				return substitute(arg->second, {});
+			}
+			return std::make_unique<Identifier>(ident->token, ident->value);
+		}
+
+		if (auto* intLit = dynamic_cast<IntegerLiteral*>(expr)) {
+			return std::make_unique<IntegerLiteral>(intLit->token, intLit->value);
+		}
+
+		if (auto* boolLit = dynamic_cast<BooleanLiteral*>(expr)) {
+			return std::make_unique<BooleanLiteral>(boolLit->token, boolLit->value);
+		}
+
+		if (auto* stringLit = dynamic_cast<StringLiteral*>(expr)) {
+			return std::make_unique<StringLiteral>(stringLit->token, stringLit->value);
+		}
+
+		if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+			auto copy = std::make_unique<PrefixExpression>(prefixExpr->token);
+			copy->oper = prefixExpr->oper;
+			copy->op = prefixExpr->op;
+			copy->right = substitute(prefixExpr->right.get(), arguments);
+			return copy;
+		}
+
+		auto* infixExpr = static_cast<InfixExpression*>(expr);
+		auto copy = std::make_unique<InfixExpression>(infixExpr->token);
+		copy->oper = infixExpr->oper;
+		copy->op = infixExpr->op;
+		copy->left = substitute(infixExpr->left.get(), arguments);
+		copy->right = substitute(infixExpr->right.get(), arguments);
+		return copy;
+	}
+};
+
+}
+
+size_t ConstantFolding::run(Program& program) {
+	Folder folder;
+	folder.walkStatements(program.statements);
+	return folder.rewrites;
+}
+
+size_t DeadCodeElimination::run(Program& program) {
+	DeadCodeEliminator eliminator;
+	eliminator.walkStatements(program.statements);
+	return eliminator.rewrites;
+}
+
+size_t FunctionInlining::run(Program& program) {
+	size_t before = sites.size();
+
+	Inliner inliner(sites);
+	inliner.findHelpers(program);
+	inliner.walkStatements(program.statements);
+
+	return sites.size() - before;
+}
+
+void FunctionInlining::printReport(std::ostream& out) const {
+	for (const std::string& site : sites) {
+		out << "  inlined " << site << "\n";
+	}
+}
+
+PassManager::PassManager(int level) {
+	if (level >= 1) {
+		addPass(std::make_unique<ConstantFolding>());
+		addPass(std::make_unique<DeadCodeElimination>());
+	}
+
+	// type inference annotates the tree the passes before it leave, so it has to come last
+	if (level >= 2) {
+		addPass(std::make_unique<FunctionInlining>());
+		addPass(std::make_unique<TypeInference>());
+	}
+}
+
+void PassManager::addPass(std::unique_ptr<Pass> pass) {
+	PassStats stats;
+	stats.name = pass->name();
+
+	passes.push_back(std::move(pass));
+	passStats.push_back(stats);
+}
+
+void PassManager::run(Program& program) {
+	for (size_t i = 0; i < passes.size(); i++) {
+		PassStats& stats = passStats[i];
+		stats.nodesBefore += countNodes(&program);
+
+		auto start = std::chrono::steady_clock::now();
+		stats.rewrites += passes[i]->run(program);
+		stats.time += std::chrono::steady_clock::now() - start;
+
+		stats.nodesAfter += countNodes(&program);
+		stats.runs++;
+	}
+}
+
+void PassManager::printStats(std::ostream& out) const {
+	for (const PassStats& stats : passStats) {
+		out << stats.name << ": " << stats.runs << " runs, " << stats.rewrites << " rewrites, "
+			<< stats.nodesBefore << " -> " << stats.nodesAfter << " nodes, "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(stats.time).count() << "us\n";
+	}
+
+	for (const auto& pass : passes) {
+		pass->printReport(out);
+	}
+}
+
+size_t countNodes(Node* node) {
+	size_t count = 0;
+	forEachNode(node, [&count](Node*) { count++; });
+	return count;
+}
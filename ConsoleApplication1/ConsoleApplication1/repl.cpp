@@ -1,68 +1,198 @@
-﻿#include <iostream>
-#include <sstream>
-#include <fstream>
-#include <string>
-#include <vector>
-#include "lexer.hpp"
-#include "token.hpp"
-#include "parser.hpp"
-#include "ast.hpp"
-#include "evaluator.hpp"
-
-std::string PROMPT = ">>"; 
-
-void printParseErrors(std::ostream& out, const std::vector<std::string>& errors) {
-	for (const std::string& error : errors) {
-		out << "\t" << error << "\n";
-	}
-}
-
-void Start(std::istream& in, std::ostream& out) {
-
-	std::string line; // storing each line of the user input
-	std::shared_ptr<Environment> env = std::make_shared<Environment>();
-	std::vector<std::unique_ptr<Program>> programs;
-
-	while (true) {
-		out << PROMPT;
-
-		// if it can't get anything anymore, return
-		if (!std::getline(in, line)) {
-			return;
-		}
-
-		std::unique_ptr<Lexer> l = std::make_unique<Lexer>(line);
-		Parser p(l);
-		std::unique_ptr<Program> program = p.parseProgram();
-
-		std::vector<std::string> errors = p.getErrors();
-
-		if (errors.size() != 0) {
-			printParseErrors(out, errors);
-			continue;
-		}
-
-		// showing parser results
-		/*out << program->string();
-		out << '\n';*/
-
-
-		std::unique_ptr<Object> evaluator = eval(program.get(), env);
-
-		programs.push_back(std::move(program));
-
-		if (evaluator != nullptr) {
-			out << evaluator->Inspect();
-			out << '\n';
-		}
-
-	}
-
-}
-
-int main() {
-	Start(std::cin, std::cout);
-
-
-	return 0;
-}
+﻿#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "lexer.hpp"
+#include "token.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "evaluator.hpp"
+#include "gc.hpp"
+#include "stack_machine.hpp"
+#include "closure_compiler.hpp"
+#include "aot.hpp"
+#include "optimizer.hpp"
+#include "inline_cache.hpp"
+#include "jit.hpp"
+#include "memoizer.hpp"
+#include "specializer.hpp"
+#include "type_inference.hpp"
+#include "repl.hpp"
+
+std::string PROMPT = ">>"; 
+
+void printParseErrors(std::ostream& out, const std::vector<std::string>& errors) {
+	for (const std::string& error : errors) {
+		out << "\t" << error << "\n";
+	}
+}
+
+void Start(std::istream& in, std::ostream& out, const ReplOptions& options) {
+
+	std::string line; // storing each line of the user input
+	GcConfig gcConfig;
+	gcConfig.memoryLimit = options.memoryLimit;
+	gcConfig.jit = options.jit;
+	gcConfig.specializer = options.specializer;
+	gcConfig.memo = options.memo;
+	Heap heap(gcConfig); // owns every environment of the session, so closures forming cycles get collected
+	EnvironmentRef env = heap.newEnvironment(nullptr);
+	// functions own the code they run, so a line's program goes away once it has run. Native builds
+	// point into theirs, and the cache and type statistics are read from every line when the input ends
+	bool keepPrograms = options.engine == Engine::Native || options.cacheStats || options.typeStats;
+	std::vector<std::unique_ptr<Program>> programs;
+	std::vector<std::unique_ptr<AotModule>> modules; // unlinked before the programs they were built from go away
+	PassManager passManager(options.optimizationLevel);
+
+	while (true) {
+		out << PROMPT;
+
+		// if it can't get anything anymore, return
+		if (!std::getline(in, line)) {
+			if (options.passStats) {
+				out << '\n';
+				passManager.printStats(out);
+				if (options.specializer.enabled) {
+					printSpecializerStats(out, specializerStats);
+				}
+				if (options.memo.enabled) {
+					printMemoStats(out, memoStats);
+				}
+			}
+			if (options.cacheStats) {
+				InlineCacheStats stats;
+				for (const auto& previous : programs) {
+					stats += collectInlineCacheStats(previous.get());
+				}
+				out << '\n';
+				printInlineCacheStats(out, stats);
+			}
+			if (options.typeStats) {
+				TypeCoverage coverage;
+				for (const auto& previous : programs) {
+					coverage += collectTypeCoverage(previous.get());
+				}
+				out << '\n';
+				printTypeCoverage(out, coverage);
+			}
+			return;
+		}
+
+		std::unique_ptr<Lexer> l = std::make_unique<Lexer>(line);
+		Parser p(l);
+		std::unique_ptr<Program> program = p.parseProgram();
+
+		std::vector<std::string> errors = p.getErrors();
+
+		if (errors.size() != 0) {
+			printParseErrors(out, errors);
+			continue;
+		}
+
+		// showing parser results
+		/*out << program->string();
+		out << '\n';*/
+
+		passManager.run(*program);
+
+		ObjectRef evaluator;
+		switch (options.engine) {
+		case Engine::Tree:
+			evaluator = eval(program.get(), env);
+			break;
+		case Engine::HeapStack:
+			evaluator = evalOnHeapStack(program.get(), env, options.stackMachine);
+			break;
+		case Engine::Closures:
+			evaluator = evalCompiled(program.get(), env);
+			break;
+		case Engine::Native: {
+			std::string error;
+			std::unique_ptr<AotModule> module = AotModule::build(program.get(), options.aot, error);
+			if (!module) {
+				out << "\t" << error << "\n";
+				continue;
+			}
+			evaluator = module->run(env);
+			modules.push_back(std::move(module));
+			break;
+		}
+		}
+
+		if (keepPrograms) {
+			programs.push_back(std::move(program));
+		}
+
+		if (evaluator != nullptr) {
+			out << evaluator->Inspect();
+			out << '\n';
+		}
+
+	}
+
+}
+
+// usage: repl [--heap-stack|--closures|--aot] [--aot-include=DIR] [--max-depth=N] [--jit] [--jit-threshold=N] [--specialize] [--memoize] [--memo-entries=N] [--memory-limit=BYTES] [-O0|-O1|-O2] [--pass-stats] [--cache-stats] [--type-stats]
+int main(int argc, char** argv) {
+	ReplOptions options;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+
+		if (arg == "--heap-stack") {
+			options.engine = Engine::HeapStack;
+		}
+		else if (arg == "--closures") {
+			options.engine = Engine::Closures;
+		}
+		else if (arg == "--aot") {
+			options.engine = Engine::Native;
+		}
+		else if (arg.rfind("--aot-include=", 0) == 0) {
+			options.aot.includeDir = arg.substr(std::string("--aot-include=").size());
+		}
+		else if (arg.rfind("--max-depth=", 0) == 0) {
+			options.stackMachine.maxDepth = std::stoul(arg.substr(std::string("--max-depth=").size()));
+		}
+		else if (arg == "--jit") {
+			options.jit.enabled = true;
+		}
+		else if (arg.rfind("--jit-threshold=", 0) == 0) {
+			options.jit.threshold = std::stoul(arg.substr(std::string("--jit-threshold=").size()));
+		}
+		else if (arg == "--specialize") {
+			options.specializer.enabled = true;
+		}
+		else if (arg == "--memoize") {
+			options.memo.enabled = true;
+		}
+		else if (arg.rfind("--memo-entries=", 0) == 0) {
+			options.memo.maxEntries = std::stoul(arg.substr(std::string("--memo-entries=").size()));
+		}
+		else if (arg.rfind("--memory-limit=", 0) == 0) {
+			options.memoryLimit = std::stoul(arg.substr(std::string("--memory-limit=").size()));
+		}
+		else if (arg == "-O0" || arg == "-O1" || arg == "-O2") {
+			options.optimizationLevel = arg[2] - '0';
+		}
+		else if (arg == "--pass-stats") {
+			options.passStats = true;
+		}
+		else if (arg == "--cache-stats") {
+			options.cacheStats = true;
+		}
+		else if (arg == "--type-stats") {
+			options.typeStats = true;
+		}
+		else {
+			std::cerr << "unknown option: " << arg << "\n";
+			return 1;
+		}
+	}
+
+	Start(std::cin, std::cout, options);
+
+
+	return 0;
+}
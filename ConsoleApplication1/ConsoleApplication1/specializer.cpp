@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+#include "specializer.hpp"
+#include "optimizer.hpp"
+
+thread_local SpecializerStats specializerStats;
+
+namespace {
+
+// literals, which are all a call site can pass that is known before the call
+bool isConstant(Expression* expr) {
+	return dynamic_cast<IntegerLiteral*>(expr) || dynamic_cast<BooleanLiteral*>(expr) || dynamic_cast<StringLiteral*>(expr);
+}
+
+// the constants at site with their positions, empty when it passes none
+std::string constantKey(CallExpression* site) {
+	std::ostringstream key;
+
+	for (size_t i = 0; i < site->arguments.size(); i++) {
+		Expression* arg = site->arguments[i].get();
+
+		if (auto* intLit = dynamic_cast<IntegerLiteral*>(arg)) {
+			key << i << 'i' << intLit->value << ';';
+		}
+		else if (auto* boolLit = dynamic_cast<BooleanLiteral*>(arg)) {
+			key << i << 'b' << boolLit->value << ';';
+		}
+		else if (auto* stringLit = dynamic_cast<StringLiteral*>(arg)) {
+			key << i << 's' << stringLit->value.size() << ':' << stringLit->value << ';';
+		}
+	}
+
+	return key.str();
+}
+
+// @brief copies a function body, replacing the parameters bound to constants by those constants.
+// Inside a nested function that takes a parameter of the same name, the name is left alone
+class Residualizer {
+public:
+	explicit Residualizer(const std::unordered_map<std::string, Expression*>& constants) : constants(constants) {}
+
+	std::unique_ptr<BlockStatement> block(BlockStatement* blockStmt) {
+		auto copy = std::make_unique<BlockStatement>(blockStmt->token);
+		for (const auto& stmt : blockStmt->statements) {
+			copy->statements.push_back(statement(stmt.get()));
+		}
+		return copy;
+	}
+
+	std::unique_ptr<Expression> expression(Expression* expr) {
+		if (!expr) {
+			return nullptr;
+		}
+
+		if (auto* ident = dynamic_cast<Identifier*>(expr)) {
+			auto constant = constants.find(ident->value);
+			if (constant != constants.end() && !isShadowed(ident->value)) {
+				return expression(constant->second);
+			}
+			return std::make_unique<Identifier>(ident->token, ident->value);
+		}
+
+		if (auto* intLit = dynamic_cast<IntegerLiteral*>(expr)) {
+			return std::make_unique<IntegerLiteral>(intLit->token, intLit->value);
+		}
+
+		if (auto* boolLit = dynamic_cast<BooleanLiteral*>(expr)) {
+			return std::make_unique<BooleanLiteral>(boolLit->token, boolLit->value);
+		}
+
+		if (auto* stringLit = dynamic_cast<StringLiteral*>(expr)) {
+			return std::make_unique<StringLiteral>(stringLit->token, stringLit->value);
+		}
+
+		if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+			auto copy = std::make_unique<PrefixExpression>(prefixExpr->token);
+			copy->oper = prefixExpr->oper;
+			copy->op = prefixExpr->op;
+			copy->right = expression(prefixExpr->right.get());
+			return copy;
+		}
+
+		if (auto* infixExpr = dynamic_cast<InfixExpression*>(expr)) {
+			auto copy = std::make_unique<InfixExpression>(infixExpr->token);
+			copy->oper = infixExpr->oper;
+			copy->op = infixExpr->op;
+			copy->left = expression(infixExpr->left.get());
+			copy->right = expression(infixExpr->right.get());
+			return copy;
+		}
+
+		if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			auto copy = std::make_unique<IfExpression>(ifExpr->token);
+			copy->condition = expression(ifExpr->condition.get());
+			copy->consequence = block(ifExpr->consequence.get());
+			if (ifExpr->alternative) {
+				copy->alternative = block(ifExpr->alternative.get());
+			}
+			return copy;
+		}
+
+		if (auto* funcLit = dynamic_cast<FunctionLiteral*>(expr)) {
+			auto copy = std::make_unique<FunctionLiteral>(funcLit->token);
+			size_t scopeSize = shadowed.size();
+			for (const auto& param : funcLit->parameters) {
+				copy->parameters.push_back(std::make_unique<Identifier>(param->token, param->value));
+				shadowed.push_back(param->value);
+			}
+			if (funcLit->body) {
+				copy->body = block(funcLit->body.get());
+			}
+			shadowed.resize(scopeSize);
+			return copy;
+		}
+
+		auto* callExpr = static_cast<CallExpression*>(expr);
+		auto copy = std::make_unique<CallExpression>(callExpr->token);
+		copy->function = expression(callExpr->function.get());
+		for (const auto& arg : callExpr->arguments) {
+			copy->arguments.push_back(expression(arg.get()));
+		}
+		// the expansion is made of names at the call, so it takes the same substitution
+		if (callExpr->inlined) {
+			copy->inlined = expression(callExpr->inlined.get());
+			copy->inlinedFrom = callExpr->inlinedFrom;
+		}
+		return copy;
+	}
+
+private:
+	const std::unordered_map<std::string, Expression*>& constants;
+	std::vector<std::string> shadowed; // parameters of the nested functions being copied
+
+	bool isShadowed(const std::string& name) const {
+		return std::find(shadowed.begin(), shadowed.end(), name) != shadowed.end();
+	}
+
+	std::unique_ptr<Statement> statement(Statement* stmt) {
+		if (auto* letStmt = dynamic_cast<LetStatement*>(stmt)) {
+			auto copy = std::make_unique<LetStatement>(letStmt->token);
+			copy->name = std::make_unique<Identifier>(letStmt->name->token, letStmt->name->value);
+			copy->value = expression(letStmt->value.get());
+			return copy;
+		}
+
+		if (auto* returnStmt = dynamic_cast<ReturnStatement*>(stmt)) {
+			auto copy = std::make_unique<ReturnStatement>(returnStmt->token);
+			copy->value = expression(returnStmt->value.get());
+			return copy;
+		}
+
+		if (auto* blockStmt = dynamic_cast<BlockStatement*>(stmt)) {
+			return block(blockStmt);
+		}
+
+		auto* exprStmt = static_cast<ExpressionStatement*>(stmt);
+		auto copy = std::make_unique<ExpressionStatement>(exprStmt->token);
+		copy->value = expression(exprStmt->value.get());
+		return copy;
+	}
+};
+
+}
+
+std::shared_ptr<const Specialization> Specialization::build(Function* function, CallExpression* site) {
+	// a let of a parameter's name anywhere in the body may rebind it before a use
+	std::vector<std::string> rebound;
+	forEachNode(function->body, [&rebound](Node* node) {
+		if (auto* letStmt = dynamic_cast<LetStatement*>(node)) {
+			rebound.push_back(letStmt->name->value);
+		}
+	});
+
+	auto specialization = std::make_shared<Specialization>();
+	std::unordered_map<std::string, Expression*> constants;
+
+	for (size_t i = 0; i < function->parameters.size(); i++) {
+		Identifier* param = function->parameters[i];
+		Expression* arg = site->arguments[i].get();
+
+		// a name listed twice is bound to the last argument for it
+		bool bindsOnce = std::find(rebound.begin(), rebound.end(), param->value) == rebound.end()
+			&& std::count_if(function->parameters.begin(), function->parameters.end(),
+				[param](Identifier* other) { return other->value == param->value; }) == 1;
+
+		if (isConstant(arg) && bindsOnce) {
+			constants[param->value] = arg;
+		}
+		else {
+			specialization->kept.push_back(i);
+		}
+	}
+
+	if (constants.empty()) {
+		return nullptr;
+	}
+
+	Residualizer residualizer(constants);
+	auto funcLit = std::make_unique<FunctionLiteral>(Token{ TokenTypes::FUNCTION, "fn" });
+	for (size_t i : specialization->kept) {
+		Identifier* param = function->parameters[i];
+		funcLit->parameters.push_back(std::make_unique<Identifier>(param->token, param->value));
+	}
+	funcLit->body = residualizer.block(function->body);
+
+	auto exprStmt = std::make_unique<ExpressionStatement>(funcLit->token);
+	exprStmt->value = std::move(funcLit);
+	specialization->residual = std::make_unique<Program>();
+	specialization->residual->statements.push_back(std::move(exprStmt));
+
+	PassManager(2).run(*specialization->residual);
+
+	auto* residualLit = static_cast<FunctionLiteral*>(
+		static_cast<ExpressionStatement*>(specialization->residual->statements[0].get())->value.get());
+	for (const auto& param : residualLit->parameters) {
+		specialization->parameters.push_back(param.get());
+	}
+	specialization->body = residualLit->body.get();
+
+	return specialization;
+}
+
+void Specialization::bindArguments(Environment& env, Arguments args) const {
+	for (size_t i = 0; i < parameters.size(); i++) {
+		env.setObject(parameters[i]->symbol, args[kept[i]]);
+	}
+}
+
+std::string Specialization::string() const {
+	return residual->statements[0]->string();
+}
+
+const Specialization* specialize(Function* function, CallExpression* site, const SpecializerConfig& config) {
+	if (!site || !function->body || site->arguments.size() != function->parameters.size()) {
+		return nullptr;
+	}
+
+	if (!site->constantKeyKnown) {
+		site->constantKey = constantKey(site);
+		site->constantKeyKnown = true;
+	}
+
+	const std::string& key = site->constantKey;
+	if (key.empty()) {
+		return nullptr;
+	}
+
+	auto& entries = function->body->specializations.entries;
+	auto entry = entries.find(key);
+
+	if (entry == entries.end()) {
+		if (entries.size() >= config.maxPerFunction) {
+			specializerStats.skipped++;
+			return nullptr;
+		}
+
+		entry = entries.emplace(key, Specialization::build(function, site)).first;
+		if (entry->second) {
+			specializerStats.specialized++;
+		}
+	}
+
+	if (!entry->second) {
+		return nullptr;
+	}
+
+	specializerStats.calls++;
+	return entry->second.get();
+}
+
+void printSpecializerStats(std::ostream& out, const SpecializerStats& stats) {
+	out << "specializations: " << stats.specialized << " built, " << stats.calls << " calls, "
+		<< stats.skipped << " calls past the limit\n";
+}
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "optimizer.hpp"
+#include "specializer.hpp"
+#include "test_helpers.hpp"
+
+// ====== HELPER FUNCTIONS ======
+
+// the residual of the function defined by the program's first statement for the call in its last
+static std::string residualOf(const std::string& input) {
+    std::unique_ptr<Program> program = parse(input);
+    auto env = makeRef<Environment>();
+    eval(program.get(), env);
+
+    auto* letStmt = static_cast<LetStatement*>(program->statements.front().get());
+    auto* callExpr = static_cast<CallExpression*>(
+        static_cast<ExpressionStatement*>(program->statements.back().get())->value.get());
+
+    ObjectRef fn = env->getObject(letStmt->name->value).first;
+    std::shared_ptr<const Specialization> specialization =
+        Specialization::build(static_cast<Function*>(fn.get()), callExpr);
+    return specialization ? specialization->string() : "none";
+}
+
+// ====== TEST FUNCTIONS ======
+
+static void TestResidualFunctions() {
+    std::vector<std::pair<std::string, std::string>> tests = {
+        {"let f = fn(mode, x) { if (mode == 1) { x * 2 } else { x + 100 } }; f(1, y)", "fn(x)(x * 2)"},
+        {"let f = fn(mode, x) { if (mode == 1) { x * 2 } else { x + 100 } }; f(2, y)", "fn(x)(x + 100)"},
+        {"let f = fn(a, b) { a * b + 1 }; f(3, 4)", "fn()13"},
+        {R"(let f = fn(s, n) { s + "!" }; f("hi", 1))", "fn()hi!"},
+        // a nested parameter shadows, a let rebinds, a name listed twice takes the last argument
+        {"let f = fn(a, b) { fn(a) { a + b } }; f(1, 2)", "fn()fn(a)(a + 2)"},
+        {"let f = fn(a, b) { let a = a + 1; a * b }; f(1, 2)", "fn(a)let a=(a + 1);(a * 2)"},
+        {"let f = fn(a, a) { a }; f(1, 2)", "none"},
+        {"let f = fn(a, b) { a + b }; f(a, b)", "none"},
+    };
+
+    for (const auto& [input, expected] : tests) {
+        std::string got = residualOf(input);
+        if (got != expected) {
+            std::cerr << "wrong residual for \"" << input << "\". expected=\"" << expected
+                      << "\", got=\"" << got << "\"\n";
+            return;
+        }
+    }
+
+    std::cout << "TestResidualFunctions passed!\n";
+}
+
+static void TestSpecializedEvalMatchesEval() {
+    std::vector<std::string> inputs = {
+        "let f = fn(mode, x) { if (mode == 1) { x * 2 } else { x + 100 } }; f(1, 5) + f(2, 5)",
+        "let sum = fn(n, step, acc) { if (n < 1) { acc } else { sum(n - step, 2, acc + n) } }; sum(100, 2, 0)",
+        "let f = fn(a, b) { let a = a + 1; a * b }; f(1, 2)",
+        "let f = fn(a, a) { a }; f(1, 2)",
+        "let f = fn(a, b) { fn(a) { a + b } }; f(1, 2)(10)",
+        "let f = fn(a) { a / 0 }; f(5)",
+        "let f = fn(a, b) { a + b }; f(true, 1)",
+        R"(let f = fn(s, n) { if (n > 1) { s + s } else { s } }; f("ab", 2))",
+        "let f = fn(a) { a }; f(1, 2)",
+        "let outer = fn(k) { fn(x) { x + k } }; let add5 = outer(5); add5(1) + add5(2)",
+    };
+
+    for (const auto& input : inputs) {
+        std::string expected = evaluated(input, &GcConfig::specializer, false, 1);
+        std::string got = evaluated(input, &GcConfig::specializer, true, 1);
+
+        if (expected != got) {
+            std::cerr << "specialized result differs for \"" << input << "\". expected=" << expected
+                      << ", got=" << got << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestSpecializedEvalMatchesEval passed!\n";
+}
+
+static void TestSpecializationCache() {
+    SpecializerStats before = specializerStats;
+
+    // loop for acc = 0 and f for three modes, each built once however often it's called
+    std::string result = evaluated(
+        "let f = fn(mode, x) { if (mode == 1) { x } else { x * mode } }; "
+        "let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1, acc + f(1, n) + f(2, n) + f(3, n)) } }; "
+        "let start = 10; loop(start, 0)", &GcConfig::specializer, true, 1);
+
+    size_t built = specializerStats.specialized - before.specialized;
+    size_t calls = specializerStats.calls - before.calls;
+    if (result != "INTEGER 330" || built != 4 || calls != 31) {
+        std::cerr << "wrong cache use. result=" << result << ", built=" << built << ", calls=" << calls << "\n";
+        return;
+    }
+
+    // past the limit, calls with new constants are made as usual
+    GcConfig config;
+    config.specializer.enabled = true;
+    config.specializer.maxPerFunction = 1;
+    before = specializerStats;
+    result = evaluated("let f = fn(a) { a * 2 }; f(1) + f(2) + f(1)", config, 1);
+
+    if (result != "INTEGER 8" || specializerStats.specialized - before.specialized != 1
+        || specializerStats.calls - before.calls != 2 || specializerStats.skipped - before.skipped != 1) {
+        std::cerr << "wrong limit handling. result=" << result << "\n";
+        return;
+    }
+
+    std::cout << "TestSpecializationCache passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestResidualFunctions();
+//    TestSpecializedEvalMatchesEval();
+//    TestSpecializationCache();
+//    return 0;
+//}
@@ -0,0 +1,353 @@
+#include <vector>
+#include "stack_machine.hpp"
+#include "evaluator.hpp"
+#include "gc.hpp"
+#include "inline_cache.hpp"
+
+namespace {
+
+enum class FrameKind {
+	Program,
+	Block,
+	Prefix,
+	Infix,
+	If,
+	Return,
+	Let,
+	Call,
+	Body, // a function call in progress: unwraps the return value and releases the depth
+};
+
+// @brief a continuation: the node being evaluated and how far along it is
+struct Frame {
+	FrameKind kind;
+	Node* node;
+	EnvironmentRef env;
+	size_t step = 0;             // progress through the node's children
+	ObjectRef saved;             // left operand of an infix, callee of a call
+	std::vector<ObjectRef> args; // evaluated call arguments
+
+	Frame(FrameKind k, Node* n, EnvironmentRef e) : kind(k), node(n), env(std::move(e)) {};
+};
+
+class StackMachine {
+public:
+	explicit StackMachine(const StackMachineConfig& conf) : config(conf), depth(0) {};
+
+	ObjectRef run(Node* node, EnvironmentRef env) {
+		evaluate(node, std::move(env));
+
+		while (!stack.empty()) {
+			step();
+		}
+
+		return value;
+	}
+
+private:
+	const StackMachineConfig& config;
+	std::vector<Frame> stack;
+	ObjectRef value; // result of the last completed node
+	size_t depth;    // Body frames currently on the stack
+
+	// leaves are evaluated on the spot, everything else gets a frame
+	void evaluate(Node* node, EnvironmentRef env) {
+		if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(node)) {
+			evaluate(exprStmt->value.get(), std::move(env));
+		}
+		else if (auto* ident = dynamic_cast<Identifier*>(node)) {
+			value = evalIdentifier(ident, env);
+		}
+		else if (auto* intLit = dynamic_cast<IntegerLiteral*>(node)) {
+			value = newObject<Integer>(env->heap, intLit->value);
+		}
+		else if (auto* boolLit = dynamic_cast<BooleanLiteral*>(node)) {
+			value = newObject<Boolean>(env->heap, boolLit->value);
+		}
+		else if (auto* stringLit = dynamic_cast<StringLiteral*>(node)) {
+			value = newString(env->heap, stringLit->value);
+		}
+		else if (auto* funcLit = dynamic_cast<FunctionLiteral*>(node)) {
+			value = evalFunctionLiteral(funcLit, env);
+		}
+		else if (dynamic_cast<Program*>(node)) {
+			stack.emplace_back(FrameKind::Program, node, std::move(env));
+		}
+		else if (dynamic_cast<BlockStatement*>(node)) {
+			stack.emplace_back(FrameKind::Block, node, std::move(env));
+		}
+		else if (dynamic_cast<PrefixExpression*>(node)) {
+			stack.emplace_back(FrameKind::Prefix, node, std::move(env));
+		}
+		else if (dynamic_cast<InfixExpression*>(node)) {
+			stack.emplace_back(FrameKind::Infix, node, std::move(env));
+		}
+		else if (dynamic_cast<IfExpression*>(node)) {
+			stack.emplace_back(FrameKind::If, node, std::move(env));
+		}
+		else if (dynamic_cast<ReturnStatement*>(node)) {
+			stack.emplace_back(FrameKind::Return, node, std::move(env));
+		}
+		else if (dynamic_cast<LetStatement*>(node)) {
+			stack.emplace_back(FrameKind::Let, node, std::move(env));
+		}
+		else if (dynamic_cast<CallExpression*>(node)) {
+			stack.emplace_back(FrameKind::Call, node, std::move(env));
+		}
+		else {
+			value = nullptr;
+		}
+	}
+
+	// pops the top frame, handing 'result' to the frame below
+	void finish(ObjectRef result) {
+		stack.pop_back();
+		value = std::move(result);
+	}
+
+	// resumes the top frame; 'value' holds the result of the child it was waiting for.
+	// evaluate() may grow the stack, so it is always the last use of 'frame'
+	void step() {
+		Frame& frame = stack.back();
+
+		switch (frame.kind) {
+		case FrameKind::Program:
+		case FrameKind::Block: {
+			const auto& statements = frame.kind == FrameKind::Program
+				? static_cast<Program*>(frame.node)->statements
+				: static_cast<BlockStatement*>(frame.node)->statements;
+
+			if (frame.step == 0) {
+				value = nullptr;
+			}
+			else if (value && value->kind() == ObjectKind::ReturnValue) {
+				// a program ends at its first return; a block hands it up to the function body
+				finish(frame.kind == FrameKind::Program ? unwrapReturnValue(value) : value);
+				return;
+			}
+			else if (isError(value.get())) {
+				finish(value);
+				return;
+			}
+
+			if (frame.step == statements.size()) {
+				finish(value);
+				return;
+			}
+
+			Statement* stmt = statements[frame.step++].get();
+			evaluate(stmt, frame.env);
+			return;
+		}
+
+		case FrameKind::Prefix: {
+			auto* prefixExpr = static_cast<PrefixExpression*>(frame.node);
+			if (frame.step++ == 0) {
+				evaluate(prefixExpr->right.get(), frame.env);
+				return;
+			}
+
+			if (isError(value.get())) {
+				finish(value);
+				return;
+			}
+
+			finish(evalPrefixExpression(prefixExpr->op, value, frame.env->heap));
+			return;
+		}
+
+		case FrameKind::Infix: {
+			auto* infixExpr = static_cast<InfixExpression*>(frame.node);
+			if (frame.step == 0) {
+				frame.step = 1;
+				evaluate(infixExpr->left.get(), frame.env);
+				return;
+			}
+
+			if (isError(value.get())) {
+				finish(value);
+				return;
+			}
+
+			if (frame.step == 1) {
+				frame.step = 2;
+				frame.saved = value;
+				evaluate(infixExpr->right.get(), frame.env);
+				return;
+			}
+
+			finish(evalInfixNode(infixExpr, std::move(frame.saved), value, frame.env->heap));
+			return;
+		}
+
+		case FrameKind::If: {
+			auto* ifExpr = static_cast<IfExpression*>(frame.node);
+			if (frame.step++ == 0) {
+				evaluate(ifExpr->condition.get(), frame.env);
+				return;
+			}
+
+			if (isError(value.get())) {
+				finish(value);
+				return;
+			}
+
+			BlockStatement* branch = isTruthy(value.get()) ? ifExpr->consequence.get() : ifExpr->alternative.get();
+			if (!branch) {
+				finish(nullptr);
+				return;
+			}
+
+			// the branch takes over this frame, so the if never sits between a call and its caller
+			frame.kind = FrameKind::Block;
+			frame.node = branch;
+			frame.step = 0;
+			return;
+		}
+
+		case FrameKind::Return: {
+			auto* returnStmt = static_cast<ReturnStatement*>(frame.node);
+			if (frame.step++ == 0) {
+				evaluate(returnStmt->value.get(), frame.env);
+				return;
+			}
+
+			if (isError(value.get())) {
+				finish(value);
+				return;
+			}
+
+			finish(newObject<ReturnValue>(frame.env->heap, value));
+			return;
+		}
+
+		case FrameKind::Let: {
+			auto* letStmt = static_cast<LetStatement*>(frame.node);
+			if (frame.step++ == 0) {
+				evaluate(letStmt->value.get(), frame.env);
+				return;
+			}
+
+			if (isError(value.get())) {
+				finish(value);
+				return;
+			}
+
+			frame.env->setObject(letStmt->name->symbol, value);
+			finish(nullptr);
+			return;
+		}
+
+		case FrameKind::Call: {
+			auto* callExpr = static_cast<CallExpression*>(frame.node);
+			if (frame.step == 0) {
+				frame.step = 1;
+				evaluate(callExpr->function.get(), frame.env);
+				return;
+			}
+
+			if (isError(value.get())) {
+				finish(value);
+				return;
+			}
+
+			if (frame.step == 1) {
+				frame.step = 2;
+				frame.saved = value;
+			}
+			else {
+				frame.args.push_back(value);
+			}
+
+			if (frame.args.size() < callExpr->arguments.size()) {
+				evaluate(callExpr->arguments[frame.args.size()].get(), frame.env);
+				return;
+			}
+
+			call(callExpr, std::move(frame.saved), std::move(frame.args));
+			return;
+		}
+
+		case FrameKind::Body: {
+			if (frame.step++ == 0) {
+				evaluate(static_cast<BlockStatement*>(frame.node), frame.env);
+				return;
+			}
+
+			depth--;
+			finish(unwrapReturnValue(value));
+			return;
+		}
+		}
+	}
+
+	// replaces the finished Call frame with the callee's Body frame
+	void call(CallExpression* site, ObjectRef fn, std::vector<ObjectRef> args) {
+		Heap* heap = stack.back().env->heap;
+		stack.pop_back();
+
+		if (!fn) {
+			value = newObject<Error>(heap, ErrorCode::NotAFunction, Operator::Unknown, ObjectKind::Count, ObjectKind::Count);
+			return;
+		}
+
+		Function* function = resolveCallee(site, fn.get());
+		if (!function) {
+			value = newObject<Error>(heap, ErrorCode::NotAFunction, Operator::Unknown, fn->kind(), ObjectKind::Count);
+			return;
+		}
+
+		if (!callFits(function)) {
+			value = newObject<Error>(heap, ErrorCode::MemoryLimitExceeded);
+			return;
+		}
+
+		// a call whose result goes straight back to the caller's caller reuses its Body frame
+		size_t tailBody = findTailBody();
+		if (tailBody != stack.size()) {
+			stack.erase(stack.begin() + tailBody, stack.end());
+			depth--;
+		}
+		else if (depth >= config.maxDepth) {
+			value = newObject<Error>(heap, ErrorCode::StackDepthExceeded);
+			return;
+		}
+
+		depth++;
+		stack.emplace_back(FrameKind::Body, function->body, extendFunctionEnv(function, args));
+	}
+
+	// index of the enclosing Body frame if everything between it and the top only passes the
+	// value through (blocks on their last statement, returns), stack.size() otherwise
+	size_t findTailBody() const {
+		bool returning = false;
+
+		for (size_t i = stack.size(); i-- > 0;) {
+			const Frame& frame = stack[i];
+
+			switch (frame.kind) {
+			case FrameKind::Return:
+				returning = true;
+				break;
+			case FrameKind::Block:
+				if (!returning && frame.step != static_cast<BlockStatement*>(frame.node)->statements.size()) {
+					return stack.size();
+				}
+				break;
+			case FrameKind::Body:
+				return i;
+			default:
+				return stack.size();
+			}
+		}
+
+		return stack.size();
+	}
+};
+
+} // namespace
+
+ObjectRef evalOnHeapStack(Node* node, EnvironmentRef env, const StackMachineConfig& config) {
+	StackMachine machine(config);
+	return machine.run(node, std::move(env));
+}
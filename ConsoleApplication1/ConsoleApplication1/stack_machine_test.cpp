@@ -0,0 +1,135 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "stack_machine.hpp"
+#include "test_helpers.hpp"
+
+// ====== HELPER FUNCTIONS ======
+
+static ObjectRef testStackEval(const std::string& input, const StackMachineConfig& config = StackMachineConfig()) {
+    auto l = std::make_unique<Lexer>(input);
+    Parser p(l);
+    std::unique_ptr<Program> program = p.parseProgram();
+    auto env = makeRef<Environment>();
+
+    return evalOnHeapStack(program.get(), env, config);
+}
+
+static ObjectRef testRecursiveEval(const std::string& input) {
+    auto l = std::make_unique<Lexer>(input);
+    Parser p(l);
+    std::unique_ptr<Program> program = p.parseProgram();
+    auto env = makeRef<Environment>();
+
+    return eval(program.get(), env);
+}
+
+// ====== TEST FUNCTIONS ======
+
+static void TestStackMachineMatchesEval() {
+    std::vector<std::string> inputs = {
+        "5 + 5 * 2 - -3",
+        "(5 + 10 * 2 + 15 / 3) * 2 + -10",
+        "!true == false",
+        "1 < 2 == true",
+        "if (1 > 2) { 10 }",
+        "if (1 > 2) { 10 } else { 20 }",
+        "9; return 2 * 5; 9;",
+        "if (10 > 1) { if (10 > 1) { return 10; } return 1; }",
+        "5 + true; 5;",
+        "-true",
+        "foobar",
+        "10 / 0",
+        R"("Hello" + " " + "World!")",
+        R"("Hello" - "World")",
+        "let a = 5; let b = a; let c = a + b + 5; c;",
+        "let add = fn(x, y) { x + y; }; add(5 + 5, add(5, 5));",
+        "fn(x) { x; }(5)",
+        "let newAdder = fn(x) { fn(y) { x + y } }; let addTwo = newAdder(2); addTwo(3);",
+        "let f = fn(x) { return x * 2; 100 }; f(4) + 1",
+        "let f = fn() { 5(1) }; f();",
+        "let f = fn(x) { let y = x + 1; y * 2 }; f(3) + f(4)",
+        "let fib = fn(n) { if (n < 2) { n } else { fib(n - 1) + fib(n - 2) } }; fib(15)",
+        "let f = fn(a, b) { a }; f(1)",
+        "let f = fn(a) { a }; f(1, 2)",
+        "let f = fn(a, b) { b }; f(1)",
+        "let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1) } }; loop(3, 7)",
+    };
+
+    for (const auto& input : inputs) {
+        std::string expected = describe(testRecursiveEval(input).get());
+        std::string got = describe(testStackEval(input).get());
+
+        if (expected != got) {
+            std::cerr << "heap stack result differs for \"" << input << "\". expected="
+                      << expected << ", got=" << got << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestStackMachineMatchesEval passed!\n";
+}
+
+static void TestStackMachineDeepRecursion() {
+    StackMachineConfig config;
+    config.maxDepth = 1000000;
+
+    // non-tail recursion far deeper than the native stack would allow
+    ObjectRef evaluated = testStackEval(
+        "let sum = fn(n) { if (n < 1) { 0 } else { n + sum(n - 1) } }; sum(200000);", config);
+
+    Integer* result = dynamic_cast<Integer*>(evaluated.get());
+    if (!result || result->value != 20000100000) {
+        std::cerr << "deep recursion wrong. got=" << describe(evaluated.get()) << "\n";
+        return;
+    }
+
+    std::cout << "TestStackMachineDeepRecursion passed!\n";
+}
+
+static void TestStackMachineDepthLimit() {
+    StackMachineConfig config;
+    config.maxDepth = 1000;
+
+    ObjectRef evaluated = testStackEval(
+        "let sum = fn(n) { if (n < 1) { 0 } else { n + sum(n - 1) } }; sum(5000);", config);
+
+    Error* err = dynamic_cast<Error*>(evaluated.get());
+    if (!err || err->message() != "stack depth exceeded") {
+        std::cerr << "expected stack depth error. got=" << describe(evaluated.get()) << "\n";
+        return;
+    }
+
+    // within the limit, and tail calls don't count towards it
+    std::vector<std::pair<std::string, int64_t>> tests = {
+        {"let sum = fn(n) { if (n < 1) { 0 } else { n + sum(n - 1) } }; sum(999);", 499500},
+        {"let loop = fn(n, acc) { if (n < 1) { acc } else { loop(n - 1, acc + 1) } }; loop(100000, 0);", 100000},
+        {"let countdown = fn(n) { if (n == 0) { return 0; } return countdown(n - 1); }; countdown(100000);", 0},
+    };
+
+    for (const auto& [input, expected] : tests) {
+        ObjectRef value = testStackEval(input, config);
+        Integer* result = dynamic_cast<Integer*>(value.get());
+        if (!result || result->value != expected) {
+            std::cerr << "wrong result for \"" << input << "\". got=" << describe(value.get()) << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestStackMachineDepthLimit passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestStackMachineMatchesEval();
+//    TestStackMachineDeepRecursion();
+//    TestStackMachineDepthLimit();
+//    return 0;
+//}
@@ -0,0 +1,51 @@
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include "symbol.hpp"
+
+namespace {
+	// shared by every interpreter in the process, which may intern from several threads
+	struct SymbolTable {
+		std::unordered_map<std::string, Symbol> symbols;
+		std::deque<std::string> names; // by symbol; a deque, so names stay put as it grows
+		std::shared_mutex mutex;
+	};
+
+	SymbolTable& symbolTable() {
+		static SymbolTable table;
+		return table;
+	}
+}
+
+Symbol intern(const std::string& name) {
+	Symbol symbol = findSymbol(name);
+	if (symbol != noSymbol) {
+		return symbol;
+	}
+
+	SymbolTable& table = symbolTable();
+	std::unique_lock<std::shared_mutex> lock(table.mutex);
+
+	auto [entry, inserted] = table.symbols.try_emplace(name, static_cast<Symbol>(table.names.size()));
+	if (inserted) {
+		table.names.push_back(name);
+	}
+
+	return entry->second;
+}
+
+Symbol findSymbol(const std::string& name) {
+	SymbolTable& table = symbolTable();
+	std::shared_lock<std::shared_mutex> lock(table.mutex);
+
+	auto entry = table.symbols.find(name);
+	return entry == table.symbols.end() ? noSymbol : entry->second;
+}
+
+// the name itself never moves, so it can be read after the lock is gone
+const std::string& symbolName(Symbol symbol) {
+	SymbolTable& table = symbolTable();
+	std::shared_lock<std::shared_mutex> lock(table.mutex);
+	return table.names[symbol];
+}
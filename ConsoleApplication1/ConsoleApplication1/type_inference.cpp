@@ -0,0 +1,249 @@
+#include <unordered_map>
+#include "type_inference.hpp"
+
+namespace {
+
+// types of the names bound so far in one environment; a missing name is Unknown
+using Scope = std::unordered_map<std::string, StaticType>;
+
+class Inferer {
+public:
+	size_t typed = 0;
+
+	void statements(const std::vector<std::unique_ptr<Statement>>& stmts, Scope& scope) {
+		for (const auto& stmt : stmts) {
+			statement(stmt.get(), scope);
+		}
+	}
+
+	StaticType expression(Expression* expr, Scope& scope) {
+		if (!expr) {
+			return StaticType::Unknown;
+		}
+
+		StaticType type = infer(expr, scope);
+		expr->staticType = type;
+		if (type != StaticType::Unknown) {
+			typed++;
+		}
+
+		return type;
+	}
+
+private:
+	void statement(Statement* stmt, Scope& scope) {
+		if (auto* letStmt = dynamic_cast<LetStatement*>(stmt)) {
+			StaticType type = expression(letStmt->value.get(), scope);
+			letStmt->name->staticType = type;
+			if (type != StaticType::Unknown) {
+				typed++;
+			}
+			bind(scope, letStmt->name->value, type);
+		}
+		else if (auto* returnStmt = dynamic_cast<ReturnStatement*>(stmt)) {
+			expression(returnStmt->value.get(), scope);
+		}
+		else if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(stmt)) {
+			expression(exprStmt->value.get(), scope);
+		}
+		else if (auto* blockStmt = dynamic_cast<BlockStatement*>(stmt)) {
+			statements(blockStmt->statements, scope);
+		}
+	}
+
+	static void bind(Scope& scope, const std::string& name, StaticType type) {
+		if (type == StaticType::Unknown) {
+			scope.erase(name);
+		}
+		else {
+			scope[name] = type;
+		}
+	}
+
+	StaticType infer(Expression* expr, Scope& scope) {
+		if (dynamic_cast<IntegerLiteral*>(expr)) {
+			return StaticType::Integer;
+		}
+
+		if (dynamic_cast<BooleanLiteral*>(expr)) {
+			return StaticType::Boolean;
+		}
+
+		if (dynamic_cast<StringLiteral*>(expr)) {
+			return StaticType::String;
+		}
+
+		if (auto* ident = dynamic_cast<Identifier*>(expr)) {
+			auto it = scope.find(ident->value);
+			return it == scope.end() ? StaticType::Unknown : it->second;
+		}
+
+		if (auto* prefixExpr = dynamic_cast<PrefixExpression*>(expr)) {
+			StaticType right = expression(prefixExpr->right.get(), scope);
+
+			if (prefixExpr->op == Operator::Bang && right != StaticType::Unknown) {
+				return StaticType::Boolean;
+			}
+			if (prefixExpr->op == Operator::Minus && right == StaticType::Integer) {
+				return StaticType::Integer;
+			}
+
+			return StaticType::Unknown;
+		}
+
+		if (auto* infixExpr = dynamic_cast<InfixExpression*>(expr)) {
+			StaticType left = expression(infixExpr->left.get(), scope);
+			StaticType right = expression(infixExpr->right.get(), scope);
+			return infixType(infixExpr, left, right);
+		}
+
+		if (auto* ifExpr = dynamic_cast<IfExpression*>(expr)) {
+			return ifType(ifExpr, scope);
+		}
+
+		if (auto* funcLit = dynamic_cast<FunctionLiteral*>(expr)) {
+			// the body runs later, in a new environment: parameters and the names it sees
+			// from outside can hold anything by then
+			Scope body;
+			if (funcLit->body) {
+				statements(funcLit->body->statements, body);
+			}
+			return StaticType::Function;
+		}
+
+		if (auto* callExpr = dynamic_cast<CallExpression*>(expr)) {
+			expression(callExpr->function.get(), scope);
+			for (const auto& arg : callExpr->arguments) {
+				expression(arg.get(), scope);
+			}
+			// the expansion runs where the call is, so its operands are typed by the caller's lets.
+			// The call stays Unknown: it falls back to a real call when the helper is rebound
+			if (callExpr->inlined) {
+				expression(callExpr->inlined.get(), scope);
+			}
+			return StaticType::Unknown;
+		}
+
+		return StaticType::Unknown;
+	}
+
+	static StaticType infixType(InfixExpression* infixExpr, StaticType left, StaticType right) {
+		if (left != right) {
+			return StaticType::Unknown;
+		}
+
+		switch (left) {
+		case StaticType::Integer:
+			switch (infixExpr->op) {
+			case Operator::Plus:
+			case Operator::Minus:
+			case Operator::Asterisk:
+				return StaticType::Integer;
+			case Operator::Slash: {
+				// only a literal divisor is known not to be zero
+				auto* divisor = dynamic_cast<IntegerLiteral*>(infixExpr->right.get());
+				return divisor && divisor->value != 0 ? StaticType::Integer : StaticType::Unknown;
+			}
+			case Operator::Lt:
+			case Operator::Gt:
+			case Operator::Eq:
+			case Operator::NotEq:
+				return StaticType::Boolean;
+			default:
+				return StaticType::Unknown;
+			}
+		case StaticType::Boolean:
+			return infixExpr->op == Operator::Eq || infixExpr->op == Operator::NotEq
+				? StaticType::Boolean : StaticType::Unknown;
+		case StaticType::String:
+			return infixExpr->op == Operator::Plus ? StaticType::String : StaticType::Unknown;
+		default:
+			return StaticType::Unknown;
+		}
+	}
+
+	StaticType ifType(IfExpression* ifExpr, Scope& scope) {
+		StaticType condition = expression(ifExpr->condition.get(), scope);
+
+		// branches share the enclosing environment, so a let in either may rebind a name
+		Scope consequence = scope;
+		StaticType consequenceType = blockType(ifExpr->consequence.get(), consequence);
+
+		Scope alternative = scope;
+		StaticType alternativeType = StaticType::Unknown;
+		if (ifExpr->alternative) {
+			alternativeType = blockType(ifExpr->alternative.get(), alternative);
+		}
+
+		// after the if a name keeps its type only if both ways through agree on it
+		scope.clear();
+		for (const auto& [name, type] : consequence) {
+			auto it = alternative.find(name);
+			if (it != alternative.end() && it->second == type) {
+				scope[name] = type;
+			}
+		}
+
+		if (condition == StaticType::Unknown || !ifExpr->alternative || consequenceType != alternativeType) {
+			return StaticType::Unknown;
+		}
+
+		return consequenceType;
+	}
+
+	// the type of a block's value: known when none of its statements can fail or return
+	StaticType blockType(BlockStatement* block, Scope& scope) {
+		statements(block->statements, scope);
+
+		StaticType type = StaticType::Unknown;
+		for (const auto& stmt : block->statements) {
+			if (auto* letStmt = dynamic_cast<LetStatement*>(stmt.get())) {
+				if (!letStmt->value || letStmt->value->staticType == StaticType::Unknown) {
+					return StaticType::Unknown;
+				}
+				type = StaticType::Unknown; // a block ending in a let has no value
+			}
+			else if (auto* exprStmt = dynamic_cast<ExpressionStatement*>(stmt.get())) {
+				if (!exprStmt->value || exprStmt->value->staticType == StaticType::Unknown) {
+					return StaticType::Unknown;
+				}
+				type = exprStmt->value->staticType;
+			}
+			else {
+				return StaticType::Unknown;
+			}
+		}
+
+		return type;
+	}
+};
+
+}
+
+size_t TypeInference::run(Program& program) {
+	Inferer inferer;
+	Scope scope;
+	inferer.statements(program.statements, scope);
+	return inferer.typed;
+}
+
+TypeCoverage collectTypeCoverage(Node* root) {
+	TypeCoverage coverage;
+
+	forEachNode(root, [&coverage](Node* node) {
+		if (auto* expr = dynamic_cast<Expression*>(node)) {
+			coverage.expressions++;
+			if (expr->staticType != StaticType::Unknown) {
+				coverage.typed++;
+			}
+		}
+	});
+
+	return coverage;
+}
+
+void printTypeCoverage(std::ostream& out, const TypeCoverage& coverage) {
+	double percent = coverage.expressions ? 100.0 * coverage.typed / coverage.expressions : 0.0;
+	out << "typed expressions: " << coverage.typed << " of " << coverage.expressions
+		<< " (" << static_cast<int>(percent + 0.5) << "%)\n";
+}
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "optimizer.hpp"
+#include "type_inference.hpp"
+#include "test_helpers.hpp"
+
+// ====== HELPER FUNCTIONS ======
+
+// the static type of the value of the program's last expression statement
+static StaticType lastType(Program* program) {
+    auto* exprStmt = dynamic_cast<ExpressionStatement*>(program->statements.back().get());
+    return exprStmt && exprStmt->value ? exprStmt->value->staticType : StaticType::Unknown;
+}
+
+// ====== TEST FUNCTIONS ======
+
+static void TestInferredTypes() {
+    struct Case {
+        std::string input;
+        StaticType expected;
+    };
+
+    std::vector<Case> cases = {
+        { "5", StaticType::Integer },
+        { "let x = 5; let y = x * 2; y + 1 < 10", StaticType::Boolean },
+        { "let s = \"a\"; s + \"b\"", StaticType::String },
+        { "let x = 5; x / 2", StaticType::Integer },
+        { "let x = 5; 10 / x", StaticType::Unknown },
+        { "let x = 5; x + true", StaticType::Unknown },
+        { "let b = true; b < false", StaticType::Unknown },
+        { "!foo", StaticType::Unknown },
+        { "let x = 5; !x", StaticType::Boolean },
+        { "x + 1", StaticType::Unknown },
+        { "let x = 5; let f = fn() { x }; let x = true; x", StaticType::Boolean },
+        { "let x = 5; if (x > 1) { let x = true; } x", StaticType::Unknown },
+        { "let x = 5; if (x > 1) { let x = 6; } else { 1 } x", StaticType::Integer },
+        { "let x = 5; if (x > 1) { x } else { 0 }", StaticType::Integer },
+        { "let x = 5; if (x > 1) { x }", StaticType::Unknown },
+        { "let x = 5; if (x > 1) { return x; } else { 0 }", StaticType::Unknown },
+        { "let f = fn(x) { x }; f(1)", StaticType::Unknown },
+        { "let f = fn(x) { x }; f", StaticType::Function },
+    };
+
+    for (const auto& c : cases) {
+        std::unique_ptr<Program> program = parse(c.input);
+        TypeInference().run(*program);
+
+        StaticType got = lastType(program.get());
+        if (got != c.expected) {
+            std::cerr << "wrong type for \"" << c.input << "\". expected=" << static_cast<int>(c.expected)
+                      << ", got=" << static_cast<int>(got) << "\n";
+            return;
+        }
+    }
+
+    // parameters are never typed, but a function's own lets are
+    std::unique_ptr<Program> program = parse("fn(n) { let k = 3; n * k; k * k }");
+    TypeInference().run(*program);
+    auto* funcLit = dynamic_cast<FunctionLiteral*>(
+        static_cast<ExpressionStatement*>(program->statements[0].get())->value.get());
+    auto* usesParameter = static_cast<ExpressionStatement*>(funcLit->body->statements[1].get());
+    auto* usesLocal = static_cast<ExpressionStatement*>(funcLit->body->statements[2].get());
+    if (usesParameter->value->staticType != StaticType::Unknown || usesLocal->value->staticType != StaticType::Integer) {
+        std::cerr << "wrong types in a function body\n";
+        return;
+    }
+
+    std::cout << "TestInferredTypes passed!\n";
+}
+
+static void TestTypedEvalMatchesEval() {
+    std::vector<std::string> inputs = {
+        "let a = 12; let b = 7; a * b + a - b * 3 / 2",
+        "let a = 12; let b = -a; (a + b) * (a - b) == 0",
+        "let t = true; let f = !t; (t == f) != (1 < 2)",
+        "let x = 5; !x == !!false",
+        "let x = 5; let y = if (x > 2) { x * 10 } else { 0 }; y + 1",
+        "let s = \"ab\"; let n = 3; !s == (n > 4)",
+        "let f = fn(n) { let k = 3; k * k + n }; f(1) + f(2)",
+        "let x = 5; if (x > 1) { let x = true; } x",
+        "let x = 9223372036854775807; x + 1",
+        "let m = -9223372036854775807 - 1; let n = -1; -m + m / n * 2",
+        "let m = -9223372036854775807 - 1; m / -1",
+    };
+
+    for (const auto& input : inputs) {
+        std::string expected = evaluated(input);
+        std::string got = evaluated(input, 2);
+
+        if (expected != got) {
+            std::cerr << "typed result differs for \"" << input << "\". expected="
+                      << expected << ", got=" << got << "\n";
+            return;
+        }
+    }
+
+    std::cout << "TestTypedEvalMatchesEval passed!\n";
+}
+
+static void TestTypeCoverage() {
+    // x (the let's name), 3, x + 1, x, 1, f(x), f, x: only f and the call stay untyped
+    std::unique_ptr<Program> program = parse("let x = 3; x + 1; f(x)");
+    size_t typed = TypeInference().run(*program);
+    TypeCoverage coverage = collectTypeCoverage(program.get());
+
+    if (coverage.expressions != 8 || coverage.typed != 6 || typed != coverage.typed) {
+        std::cerr << "wrong coverage. expressions=" << coverage.expressions << ", typed=" << coverage.typed
+                  << ", reported=" << typed << "\n";
+        return;
+    }
+
+    std::cout << "TestTypeCoverage passed!\n";
+}
+
+// ====== MAIN ======
+
+//int main() {
+//    TestInferredTypes();
+//    TestTypedEvalMatchesEval();
+//    TestTypeCoverage();
+//    return 0;
+//}
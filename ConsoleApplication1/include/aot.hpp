@@ -0,0 +1,57 @@
+#ifndef AOT_HPP
+#define AOT_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+#include "aot_runtime.hpp"
+
+// @brief where the interpreter's headers are installed: the MONKEY_INCLUDE_DIR environment variable,
+// else the MONKEY_INCLUDE_DIR macro the interpreter was built with; empty when neither is set
+std::string defaultIncludeDir();
+
+struct AotOptions {
+	std::string compiler = "c++";
+	std::string flags = "-std=c++17 -O2 -shared -fPIC";
+	std::string includeDir = defaultIncludeDir(); // the interpreter's headers; a build fails without them
+	std::string workDir;    // where the source and the shared object are written; empty = the temp directory
+	bool keepFiles = false; // leave the generated source and build behind, for debugging
+};
+
+// @brief C++ source that runs program natively against the interpreter's objects and
+// environments, to be built as a shared object (see AotRuntime for what it links against)
+std::string generateCpp(Program* program);
+
+// @brief a program compiled ahead of time: generated C++, built by the system compiler into a
+// shared object and loaded. While loaded, the program's function bodies run natively whenever
+// native code calls them. program must outlive the module, and so must everything the module
+// ran against, as long as it may still call into native code
+class AotModule {
+public:
+	// nullptr, with the reason in error, when the build or the load fails
+	static std::unique_ptr<AotModule> build(Program* program, const AotOptions& options, std::string& error);
+
+	AotModule(const AotModule&) = delete;
+	AotModule& operator=(const AotModule&) = delete;
+	~AotModule();
+
+	// same result as eval(program, env)
+	ObjectRef run(EnvironmentRef env);
+
+private:
+	AotModule() = default;
+
+	std::vector<Node*> nodes;
+	AotRuntime runtime{};
+	void* handle = nullptr;
+	AotUnlink unlink = nullptr;
+	AotRun entry = nullptr;
+};
+
+// hash of a program's source, as checked by monkey_aot_link
+uint64_t programHash(Program* program);
+
+
+#endif // !AOT_HPP
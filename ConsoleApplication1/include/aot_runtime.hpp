@@ -0,0 +1,51 @@
+#ifndef AOT_RUNTIME_HPP
+#define AOT_RUNTIME_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+
+// bumped whenever AotRuntime or the entry points below change
+#define MONKEY_AOT_ABI_VERSION 3
+
+// @brief everything native code built by generateCpp needs from the interpreter. Native code
+// only calls through this table (and the inline parts of object.hpp), so a shared object has
+// no undefined symbols and every object it handles is allocated by the host
+struct AotRuntime {
+	int abiVersion;
+	size_t environmentSize; // sizeof(Environment) in the host, checked against the build's
+
+	// the program's nodes in forEachNode order, and a hash of its source, so a build only
+	// links against the program it was generated from
+	Node* const* nodes;
+	size_t nodeCount;
+	uint64_t sourceHash;
+
+	ObjectRef (*integer)(Heap* heap, int64_t value);
+	ObjectRef (*boolean)(Heap* heap, bool value);
+	ObjectRef (*string)(Heap* heap, const std::string& value);
+
+	ObjectRef (*identifier)(Identifier* ident, const EnvironmentRef& env); // the value, or an Error
+	void (*let)(LetStatement* letStmt, const EnvironmentRef& env, ObjectRef value);
+	ObjectRef (*prefix)(PrefixExpression* prefixExpr, ObjectRef right, Heap* heap);
+	ObjectRef (*infix)(InfixExpression* infixExpr, ObjectRef left, ObjectRef right, Heap* heap);
+
+	ObjectRef (*functionLiteral)(FunctionLiteral* funcLit, const EnvironmentRef& env);
+	ObjectRef (*call)(CallExpression* site, ObjectRef fn, std::vector<ObjectRef> args, Heap* heap);
+	ObjectRef (*tailCall)(CallExpression* site, ObjectRef fn, std::vector<ObjectRef> args, Heap* heap);
+};
+
+// entry points of a shared object built by AotModule::build
+//   int  monkey_aot_link(const AotRuntime*)   installs the native bodies, 0 when built from another program
+//   void monkey_aot_unlink()                  removes them and drops the build's constants
+//   void monkey_aot_run(const EnvironmentRef*, ObjectRef*)
+using AotLink = int(*)(const AotRuntime* runtime);
+using AotUnlink = void(*)();
+using AotRun = void(*)(const EnvironmentRef* env, ObjectRef* result);
+
+
+#endif // !AOT_RUNTIME_HPP
@@ -1,248 +1,381 @@
-#ifndef AST_HPP
-#define AST_HPP
-#include <string>
-#include <vector>
-#include <memory>
-#include "token.hpp"
-
-class Node {
-public:
-	virtual ~Node() = default;
-	virtual std::string tokenLiteral() const = 0;
-	virtual std::string string() const = 0;
-};
-
-// general definition of statements, will be used for more concise ones
-class Statement : public Node {
-public: 
-	virtual void statementLiteral() = 0;
-};
-
-class Expression : public Node {
-public:
-	virtual void expressionLiteral() = 0;
-};
-
-class Program : public Node {
-public:
-	std::vector<std::unique_ptr<Statement>> statements;
-
-	std::string tokenLiteral() const override;
-	std::string string() const override;
-};
-
-// @brief Identifier class : must have a token {IDENT | INT, 5} => value = 5 | "abc"  
-// inherits expression for cases where the identifier must return a value (e.g. let x (undefined) = defined_value + 4)
-class Identifier : public Expression{
-public:
-	Token token;
-	std::string value;
-
-	Identifier(const Token& tok, const std::string& val) : token(tok), value(val) {};
-
-	void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override {
-		return value;
-	};
-
-};
-
-// @brief token {TokenTypes::LET, let}, name : undefined_identifier, = (no need to store), value : 8 
-class LetStatement : public Statement {
-public:
-	Token token;
-	std::unique_ptr<Identifier> name;
-	std::unique_ptr<Expression> value;
-
-	LetStatement(const Token& tok) : token(tok) {};
-
-	void statementLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override;
-};
-
-// @brief just as let but composed only of the token {TokenTypes::RETURN, "return"} and value
-class ReturnStatement : public Statement {
-public:
-	Token token;
-	std::unique_ptr<Expression> value;
-
-	ReturnStatement(const Token& tok) : token(tok) {};
-
-	void statementLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override;
-};
-
-// @brief wraps the expresions as statements so that they can be stored in the vector of program
-// wraps all the expressions as : x + sum(a + b)
-class ExpressionStatement : public Statement {
-public:
-	Token token;
-	std::unique_ptr<Expression> value;
-
-	ExpressionStatement(const Token& tok) : token(tok) {};
-
-	void statementLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override;
-};
-
-class BlockStatement : public Statement{
-public:
-	Token token;
-	std::vector<std::unique_ptr<Statement>> statements;
-
-	BlockStatement(const Token& tok) : token(tok) {};
-	void statementLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override;
-
-};
-
-
-// @brief storing TokenTypes::INT as integer values
-class IntegerLiteral : public Expression {
-public:
-	Token token;
-	int64_t value;
-
-	IntegerLiteral(const Token& tok, int64_t val) : token(tok), value(val) {};
-
-	void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-
-	std::string string() const override {
-		return token.literal;
-	};
-};
-
-// @brief strogin TokenTypes::BOOL 
-class BooleanLiteral : public Expression {
-public:
-	Token token;
-	bool value;
-
-	BooleanLiteral(const Token& tok, bool val) : token(tok), value(val) {};
-
-	void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override {
-		return token.literal;
-	};
-
-};
-
-class StringLiteral : public Expression {
-public:
-	Token token;
-	std::string value;
-
-	StringLiteral(const Token& tok, const std::string& val) : token(tok), value(val) {};
-
-	void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override {
-		return token.literal;
-	};
-
-};
-
-class PrefixExpression : public Expression {
-public:
-	Token token;
-	std::string oper;
-	std::unique_ptr<Expression> right;
-
-	PrefixExpression(const Token& tok) : token(tok) {};
-
-	void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override;
-
-};
-
-class InfixExpression : public Expression {
-public:
-    Token token;
-    std::unique_ptr<Expression> left;
-    std::string oper;
-    std::unique_ptr<Expression> right;
-
-    InfixExpression(const Token& tok) : token(tok) {};
-
-    void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-    std::string string() const override;
-};
-
-class IfExpression : public Expression {
-public:
-	Token token;
-	std::unique_ptr<Expression> condition;
-	std::unique_ptr<BlockStatement> consequence;
-	std::unique_ptr<BlockStatement> alternative;
-
-	IfExpression(const Token& tok) : token(tok) {};
-
-	void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override;
-
-};
-
-class FunctionLiteral : public Expression {
-public:
-	Token token;
-	std::vector<std::unique_ptr<Identifier>> parameters;
-	std::unique_ptr<BlockStatement> body;
-
-	FunctionLiteral(const Token& tok) : token(tok) {};
-
-	void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override;
-};
-
-class CallExpression : public Expression {
-public:
-	Token token; // the '('
-	std::unique_ptr<Expression> function; //
-	std::vector<std::unique_ptr<Expression>> arguments;
-
-	CallExpression(Token tok) : token(tok) {};
-
-	void expressionLiteral() override {};
-	std::string tokenLiteral() const override {
-		return token.literal;
-	};
-	std::string string() const override;
-};
-
-
-#endif // !AST_HPP
+#ifndef AST_HPP
+#define AST_HPP
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include "token.hpp"
+#include "symbol.hpp"
+#include "ref.hpp"
+
+class Object;
+class Environment;
+class Heap;
+enum class ObjectKind : uint8_t;
+struct CompiledNode;
+class JitCode;
+class Specialization;
+
+// @brief a function body compiled ahead of time into a shared object, see AotModule
+using NativeBody = Ref<Object>(*)(const Ref<Environment>& env);
+
+// @brief operators resolved once by the parser, so evaluation indexes tables instead of comparing strings
+enum class Operator { Plus, Minus, Asterisk, Slash, Lt, Gt, Eq, NotEq, Bang, Unknown, Count };
+
+Operator toOperator(const std::string& literal);
+std::string operatorLiteral(Operator op);
+
+class Node {
+public:
+	virtual ~Node() = default;
+	virtual std::string tokenLiteral() const = 0;
+	virtual std::string string() const = 0;
+};
+
+// general definition of statements, will be used for more concise ones
+class Statement : public Node {
+public: 
+	virtual void statementLiteral() = 0;
+};
+
+// @brief what an expression is proven to evaluate to, see TypeInference. A typed expression
+// never evaluates to an Error
+enum class StaticType : uint8_t { Unknown, Integer, Boolean, String, Function };
+
+class Expression : public Node {
+public:
+	StaticType staticType = StaticType::Unknown;
+
+	virtual void expressionLiteral() = 0;
+};
+
+// calls visit on node and then on every node below it, in source order
+void forEachNode(Node* node, const std::function<void(Node*)>& visit);
+
+// @brief where an identifier node last resolved, see lookupIdentifier
+struct IdentifierCache {
+	const Environment* env = nullptr; // environment holding the binding
+	uint64_t serial = 0;              // its serial, so an environment reusing the address doesn't match
+	size_t depth = 0;                 // outer hops from the evaluating environment to env
+	const Ref<Object>* entry = nullptr;
+	size_t hits = 0;
+	size_t misses = 0;
+};
+
+// @brief the callee a call node saw last, see resolveCallee
+struct CallSiteCache {
+	uint64_t code = 0; // serial of the FunctionCode the callee runs
+	size_t arity = 0;
+	bool directBind = false; // its parameters are distinct and fit in a frame's inline bindings
+	size_t hits = 0;
+	size_t misses = 0;
+};
+
+// @brief what an infix node has rewritten itself to after watching its operands, see evalInfixNode.
+// Uninitialized nodes count executions with the same operand kinds; once that reaches
+// specializeAfter they pin the kernel for those kinds. A Specialized node whose guard fails
+// goes Generic for good rather than flip back and forth
+struct InfixSpecialization {
+	using Kernel = Ref<Object>(*)(Operator op, Object* left, Object* right, Heap* heap);
+	enum class State : uint8_t { Uninitialized, Specialized, Generic };
+
+	static constexpr size_t specializeAfter = 2;
+
+	State state = State::Uninitialized;
+	ObjectKind left{};
+	ObjectKind right{};
+	size_t executions = 0; // in a row with the operand kinds above, while Uninitialized
+	Kernel kernel = nullptr;
+};
+
+// @brief tier-up state of a function body, see jitCall. Counting bodies are interpreted and
+// counted; at the threshold they are compiled to machine code, or Rejected when they do
+// more than integer and boolean arithmetic
+struct JitState {
+	enum class State : uint8_t { Counting, Compiled, Rejected };
+
+	State state = State::Counting;
+	uint32_t calls = 0;
+	std::shared_ptr<JitCode> code;
+};
+
+// @brief residual versions of a function body for the constant arguments of its call sites, see specialize
+struct SpecializationCache {
+	// keyed by the constants and their positions; nullptr when nothing could be specialized for them
+	std::unordered_map<std::string, std::shared_ptr<const Specialization>> entries;
+};
+
+// @brief whether a function body can be memoized, see isPure. Worked out on the first call
+enum class Purity : uint8_t { Unknown, Pure, Impure };
+
+// @brief whether the frame of a call can outlive it, see frameEscapes. Worked out on the first call
+enum class FrameEscape : uint8_t { Unknown, Contained, Escapes };
+
+// @brief a name a function literal's body uses without binding it, see freeVariables
+struct Capture {
+	Symbol symbol;
+	bool local; // bound by the function the literal is in, whose frame may not have bound it yet
+};
+
+class Program : public Node {
+public:
+	std::vector<std::unique_ptr<Statement>> statements;
+
+	std::string tokenLiteral() const override;
+	std::string string() const override;
+};
+
+// @brief Identifier class : must have a token {IDENT | INT, 5} => value = 5 | "abc"  
+// inherits expression for cases where the identifier must return a value (e.g. let x (undefined) = defined_value + 4)
+class Identifier : public Expression{
+public:
+	Token token;
+	std::string value;
+	Symbol symbol; // value, interned
+	uint64_t bit;  // symbolBit(symbol)
+	IdentifierCache cache;
+
+	Identifier(const Token& tok, const std::string& val) : token(tok), value(val), symbol(intern(val)), bit(symbolBit(symbol)) {};
+
+	void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override {
+		return value;
+	};
+
+};
+
+// @brief token {TokenTypes::LET, let}, name : undefined_identifier, = (no need to store), value : 8 
+class LetStatement : public Statement {
+public:
+	Token token;
+	std::unique_ptr<Identifier> name;
+	std::unique_ptr<Expression> value;
+
+	LetStatement(const Token& tok) : token(tok) {};
+
+	void statementLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override;
+};
+
+// @brief just as let but composed only of the token {TokenTypes::RETURN, "return"} and value
+class ReturnStatement : public Statement {
+public:
+	Token token;
+	std::unique_ptr<Expression> value;
+
+	ReturnStatement(const Token& tok) : token(tok) {};
+
+	void statementLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override;
+};
+
+// @brief wraps the expresions as statements so that they can be stored in the vector of program
+// wraps all the expressions as : x + sum(a + b)
+class ExpressionStatement : public Statement {
+public:
+	Token token;
+	std::unique_ptr<Expression> value;
+
+	ExpressionStatement(const Token& tok) : token(tok) {};
+
+	void statementLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override;
+};
+
+class BlockStatement : public Statement{
+public:
+	Token token;
+	std::vector<std::unique_ptr<Statement>> statements;
+	std::shared_ptr<const CompiledNode> compiledBody; // this block compiled as a function body, see compile()
+	NativeBody native = nullptr; // set while an AotModule built from this block's program is loaded
+	JitState jit; // this block as a function body
+	SpecializationCache specializations; // this block as a function body
+	Purity purity = Purity::Unknown; // this block as a function body
+	FrameEscape escape = FrameEscape::Unknown; // this block as a function body
+
+	BlockStatement(const Token& tok) : token(tok) {};
+	void statementLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override;
+
+};
+
+
+// @brief storing TokenTypes::INT as integer values
+class IntegerLiteral : public Expression {
+public:
+	Token token;
+	int64_t value;
+
+	IntegerLiteral(const Token& tok, int64_t val) : token(tok), value(val) {};
+
+	void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+
+	std::string string() const override {
+		return token.literal;
+	};
+};
+
+// @brief strogin TokenTypes::BOOL 
+class BooleanLiteral : public Expression {
+public:
+	Token token;
+	bool value;
+
+	BooleanLiteral(const Token& tok, bool val) : token(tok), value(val) {};
+
+	void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override {
+		return token.literal;
+	};
+
+};
+
+class StringLiteral : public Expression {
+public:
+	Token token;
+	std::string value;
+
+	StringLiteral(const Token& tok, const std::string& val) : token(tok), value(val) {};
+
+	void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override {
+		return token.literal;
+	};
+
+};
+
+class PrefixExpression : public Expression {
+public:
+	Token token;
+	std::string oper;
+	Operator op = Operator::Unknown;
+	std::unique_ptr<Expression> right;
+
+	PrefixExpression(const Token& tok) : token(tok) {};
+
+	void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override;
+
+};
+
+class InfixExpression : public Expression {
+public:
+    Token token;
+    std::unique_ptr<Expression> left;
+    std::string oper;
+    Operator op = Operator::Unknown;
+    std::unique_ptr<Expression> right;
+    InfixSpecialization specialization;
+
+    InfixExpression(const Token& tok) : token(tok) {};
+
+    void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+    std::string string() const override;
+};
+
+class IfExpression : public Expression {
+public:
+	Token token;
+	std::unique_ptr<Expression> condition;
+	std::unique_ptr<BlockStatement> consequence;
+	std::unique_ptr<BlockStatement> alternative;
+
+	IfExpression(const Token& tok) : token(tok) {};
+
+	void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override;
+
+};
+
+// @brief what the functions made from a literal run. The literal and those functions share it,
+// so a function keeps its parameters and body alive, not the whole program it was typed in
+struct FunctionCode {
+	std::vector<std::unique_ptr<Identifier>> parameters;
+	std::unique_ptr<BlockStatement> body;
+	uint64_t serial; // unique per code, so caches don't match code reusing the address of freed code
+
+	FunctionCode();
+};
+
+class FunctionLiteral : public Expression {
+public:
+	Token token;
+	std::shared_ptr<FunctionCode> code;
+	std::vector<std::unique_ptr<Identifier>>& parameters; // code's
+	std::unique_ptr<BlockStatement>& body;                // code's
+	std::vector<Capture> captures; // see freeVariables
+	bool capturesKnown = false;
+
+	FunctionLiteral(const Token& tok) : token(tok), code(std::make_shared<FunctionCode>()),
+		parameters(code->parameters), body(code->body) {};
+
+	void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override;
+};
+
+class CallExpression : public Expression {
+public:
+	Token token; // the '('
+	std::unique_ptr<Expression> function; //
+	std::vector<std::unique_ptr<Expression>> arguments;
+	CallSiteCache cache;
+
+	// set by FunctionInlining: the callee's body with the arguments substituted, used while
+	// the callee still evaluates to a function running the code with serial inlinedFrom
+	std::unique_ptr<Expression> inlined;
+	uint64_t inlinedFrom = 0;
+
+	// the literal arguments and their positions, the key of the callee's specialization for this
+	// call (see specialize); worked out on the first call, as the arguments don't change after that
+	std::string constantKey;
+	bool constantKeyKnown = false;
+
+	CallExpression(Token tok) : token(tok) {};
+
+	void expressionLiteral() override {};
+	std::string tokenLiteral() const override {
+		return token.literal;
+	};
+	std::string string() const override;
+};
+
+
+#endif // !AST_HPP
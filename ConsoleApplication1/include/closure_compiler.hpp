@@ -0,0 +1,35 @@
+#ifndef CLOSURE_COMPILER_HPP
+#define CLOSURE_COMPILER_HPP
+
+#include <memory>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+
+// @brief a node compiled into a function pointer plus its compiled children. Everything that
+// eval works out on every visit (which kind of node, which operator, whether it's in tail
+// position, the value of a literal) is decided once, when the node is compiled
+struct CompiledNode {
+	using Run = ObjectRef(*)(const CompiledNode& self, const EnvironmentRef& env);
+
+	Run run = nullptr;
+	Node* node = nullptr;
+	ObjectRef constant; // literals are built once and shared
+	std::vector<CompiledNode> children;
+
+	ObjectRef operator()(const EnvironmentRef& env) const {
+		return run(*this, env);
+	}
+};
+
+// @brief compiles node (a Program, statement or expression) once. Running the result gives
+// what eval(node, env) would, against the same Environment and Object types, so both engines
+// can share an interpreter session. Function bodies are compiled once too and kept on their
+// BlockStatement, including those of functions created by eval
+std::shared_ptr<const CompiledNode> compile(Node* node);
+
+// compile(node) and run it once
+ObjectRef evalCompiled(Node* node, EnvironmentRef env);
+
+
+#endif // !CLOSURE_COMPILER_HPP
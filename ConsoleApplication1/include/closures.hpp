@@ -0,0 +1,30 @@
+#ifndef CLOSURES_HPP
+#define CLOSURES_HPP
+
+#include <memory>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+
+struct CaptureConfig {
+	bool enabled = true; // closures hold upvalues of their free variables instead of the environment they're made in
+};
+
+// @brief the names funcLit's body reads before binding them as a parameter or with a let, in order
+// of first use. A let binds from the statement after it, and one inside an if only once both
+// branches bind the name; a nested literal's free variables count as reads where it is made, since
+// it can be called before a later let. Worked out with every literal nested in funcLit on first
+// use, so those know which names their enclosing function binds; a literal reached on its own (a
+// specialization's residual, say) takes all of them to be local
+const std::vector<Capture>& freeVariables(FunctionLiteral* funcLit);
+
+// @brief the environment for a closure of funcLit made in env. It binds an upvalue for each
+// free variable bound between env and its outermost environment; one env's function binds is
+// always taken from env, as an empty upvalue when its let hasn't run yet. The closure is enclosed
+// by env's outer environment, through which an empty upvalue falls back to the name outside and
+// the other free variables are reached. That is the outermost environment itself when nothing is
+// captured. The closure keeps none of the frames it was made in
+EnvironmentRef closureEnvironment(FunctionLiteral* funcLit, const EnvironmentRef& env);
+
+
+#endif // !CLOSURES_HPP
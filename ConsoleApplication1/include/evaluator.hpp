@@ -1,16 +1,29 @@
-#ifndef EVALUATOR_HPP
-#define EVALUATOR_HPP
-
-#include <iostream>
-#include <string>
-#include <memory>
-#include <utility>
-#include "object.hpp"
-#include "ast.hpp"
-
-
-
-std::unique_ptr<Object> eval(Node* node, std::shared_ptr<Environment> env);
-
-
-#endif // !EVALUATOR_HPP
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+
+
+
+ObjectRef eval(Node* node, EnvironmentRef env);
+
+// building blocks shared by the evaluation engines, so they all implement the same semantics
+bool isTruthy(Object* obj);
+bool isError(Object* obj);
+ObjectRef evalPrefixExpression(Operator op, ObjectRef right, Heap* heap);
+ObjectRef evalInfixExpression(Operator op, ObjectRef left, ObjectRef right, Heap* heap);
+// evalInfixExpression for a node of the tree, which specializes itself to the operand kinds it sees
+ObjectRef evalInfixNode(InfixExpression* infixExpr, ObjectRef left, ObjectRef right, Heap* heap);
+ObjectRef evalIdentifier(Identifier* ident, EnvironmentRef env);
+ObjectRef evalFunctionLiteral(FunctionLiteral* funcLit, EnvironmentRef env);
+EnvironmentRef extendFunctionEnv(Function* fn, Arguments args);
+ObjectRef unwrapReturnValue(ObjectRef obj);
+
+
+#endif // !EVALUATOR_HPP
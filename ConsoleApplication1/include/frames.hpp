@@ -0,0 +1,77 @@
+#ifndef FRAMES_HPP
+#define FRAMES_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+
+class Heap;
+
+struct FrameConfig {
+	bool enabled = true; // put the frames of calls that can't escape on the frame stack
+};
+
+struct FrameStats {
+	size_t stackFrames = 0;     // environments placed on the frame stack
+	size_t chunksAllocated = 0; // chunks requested from the system
+	size_t maxDepth = 0;        // most frames on the stack at once
+};
+
+// @brief whether the environment of a call of a function with this body can be kept after the
+// call returns. Only a closure keeps an environment: it holds the one it was created in, and every
+// environment enclosed by that one holds it as outer. So a body that creates no function (after
+// inlining, whose expansions are built from the call's own arguments) has a frame that dies with
+// the call. Cached on the body
+bool frameEscapes(BlockStatement* body);
+
+// @brief last-in first-out region for the environments of calls that can't escape, in chunks
+// that are kept for the next calls. Frames are released in the reverse order of their calls;
+// one released out of order is only reclaimed once every frame above it is gone
+class FrameStack {
+public:
+	static constexpr size_t chunkSize = 64 * 1024;
+
+	FrameStack() = default;
+	FrameStack(const FrameStack&) = delete;
+	FrameStack& operator=(const FrameStack&) = delete;
+
+	void* allocate(size_t bytes, size_t alignment);
+	void release(void* ptr);
+
+	// frames allocated and not released yet
+	size_t depth() const {
+		return frames.size();
+	}
+
+	const FrameStats& stats() const { return frameStats; };
+
+private:
+	struct Chunk {
+		std::unique_ptr<char[]> memory;
+		size_t size;
+		size_t used = 0;
+	};
+
+	struct Frame {
+		size_t chunk;  // index in chunks
+		size_t offset; // where the chunk's bump offset goes back to once it's released
+		void* ptr;
+		bool released = false;
+	};
+
+	std::vector<Chunk> chunks;
+	size_t current = 0;        // chunk being bumped
+	std::vector<Frame> frames; // in allocation order
+	FrameStats frameStats;
+};
+
+// the frame stack of the interpreter owning heap; environments without a heap share one per thread
+FrameStack& frameStackOf(Heap* heap);
+
+// an environment enclosed by outer, on its heap's frame stack. It must not outlive the call it's made for
+EnvironmentRef newStackFrame(EnvironmentRef outer);
+
+
+#endif // !FRAMES_HPP
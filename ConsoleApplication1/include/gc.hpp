@@ -0,0 +1,165 @@
+#ifndef GC_HPP
+#define GC_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+#include <utility>
+#include "object.hpp"
+#include "nursery.hpp"
+#include "frames.hpp"
+#include "quota.hpp"
+#include "closures.hpp"
+#include "jit.hpp"
+#include "specializer.hpp"
+#include "memoizer.hpp"
+
+// @brief settings of one interpreter, held by its heap: tuning knobs for the collector (a collection
+// runs once initialThreshold environments have been allocated since the previous one), and the ways
+// its calls may be made. Environments without a heap run with the defaults
+struct GcConfig {
+	size_t initialThreshold = 4096; // environments allocated before the first collection
+	double growthFactor = 2.0;      // next threshold = max(initialThreshold, survivors * growthFactor)
+	bool nursery = false;           // bump-allocate temporaries in the young generation; off until it measurably beats the general heap
+	size_t pretenureStringSize = 256; // longer strings go straight to the old space, promoting them would copy the payload
+	size_t framePool = 64;          // environments of finished calls kept for reuse by the next ones
+	size_t memoryLimit = 0;         // bytes the interpreter may hold at once, 0 = unlimited; see MemoryQuota
+	FrameConfig frames;
+	CaptureConfig capture;
+	JitConfig jit;
+	SpecializerConfig specializer;
+	MemoConfig memo;
+};
+
+// @brief counters exposed to the host, accumulated over the lifetime of a Heap
+struct GcStats {
+	size_t collections = 0;
+	size_t environmentsFreed = 0;
+	size_t objectsFreed = 0;
+	size_t bytesFreed = 0;           // approximate: environment slots + payloads of freed values
+	size_t liveEnvironments = 0;     // survivors of the last collection
+	size_t framesReused = 0;         // environments handed out again from the frame pool
+	std::chrono::nanoseconds lastPause{ 0 };
+	std::chrono::nanoseconds maxPause{ 0 };
+	std::chrono::nanoseconds totalPause{ 0 };
+};
+
+// @brief per-interpreter heap owning every function-call Environment.
+// Environments and Function objects form cycles (a recursive closure is stored in an upvalue of the
+// environment it captures), which reference counting alone never reclaims. The heap tracks every environment it
+// hands out and periodically runs a mark-and-sweep pass over the environment/closure graph:
+//  - roots are environments and closures referenced from outside the graph, i.e. held by the
+//    active call stack (C++ frames of eval, call frames on the frame stack) or by the host, such
+//    as the REPL global environment. Upvalues shared with such a frame are roots as well.
+//    They are found by subtracting the graph's internal references from each reference count.
+//  - everything reachable from a root is marked; unmarked environments are swept by dropping their
+//    bindings and outer link, which breaks the cycles and lets reference counting free the rest.
+// The heap must outlive every environment created through it.
+class Heap {
+public:
+	explicit Heap(GcConfig conf = GcConfig()) : config(conf), threshold(conf.initialThreshold),
+		memoryQuota(new MemoryQuota(conf.memoryLimit)), nursery(memoryQuota) {};
+	// breaks every remaining cycle, releasing whatever the interpreter still held
+	~Heap();
+
+	Heap(const Heap&) = delete;
+	Heap& operator=(const Heap&) = delete;
+
+	// allocates a tracked environment enclosed by 'outer' (nullptr for a global environment),
+	// collecting first if the allocation threshold has been reached
+	EnvironmentRef newEnvironment(EnvironmentRef outer);
+
+	// takes back the environment of a call that has returned. When nothing else holds it (the
+	// call created no closure and no environment enclosed by it survives), it is emptied and
+	// handed out again by newEnvironment, so steady-state calls allocate no environment
+	void recycle(EnvironmentRef env);
+
+	// runs a full collection immediately
+	void collect();
+
+	// allocates an object in the nursery; it is only valid to call while config.nursery is set
+	template <typename T, typename... Args>
+	Ref<T> allocateYoung(Args&&... args) {
+		T* obj = new (nursery.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		obj->young = true;
+		return Ref<T>(obj);
+	}
+
+	// allocates an object on the general heap, charged to this heap's quota
+	template <typename T, typename... Args>
+	Ref<T> allocateOld(Args&&... args) {
+		return Ref<T>(new (memoryQuota) T(std::forward<Args>(args)...));
+	}
+
+	// returns an old-space equivalent of a young value (values are immutable, so a copy is
+	// indistinguishable), or the value itself when it is already old
+	ObjectRef promote(ObjectRef obj);
+
+	// marks env and its outer chain as captured by a closure, promoting the values they already bind
+	void capture(Environment* env);
+
+	const NurseryStats& nurseryStats() const { return nursery.stats(); };
+
+	// what this heap allocates is charged to its quota, limited to config.memoryLimit
+	MemoryQuota& quota() { return *memoryQuota; };
+	const MemoryStats& memoryStats() const { return memoryQuota->stats(); };
+
+	// arguments of the calls the evaluator is making in this interpreter
+	std::vector<ObjectRef>& valueStack() { return values; };
+
+	// the frames of this interpreter's calls that can't escape
+	FrameStack& frameStack() { return frames; };
+
+	const GcStats& stats() const { return gcStats; };
+	size_t trackedEnvironments() const { return environments.size(); };
+
+	// removes env from the registry, as it is being destroyed
+	void untrack(Environment* env);
+
+	GcConfig config;
+
+private:
+	std::vector<Environment*> environments; // each one's trackedAt is its index here
+	std::vector<EnvironmentRef> framePool; // empty, and still in environments
+	size_t allocatedSinceCollection = 0;
+	size_t threshold;
+	GcStats gcStats;
+	std::vector<ObjectRef> values;
+	FrameStack frames;
+	MemoryQuota* memoryQuota; // orphaned by ~Heap, freed once nothing is charged to it any more
+	Nursery nursery; // declared last: destroyed first, so orphaned chunks are handed to their objects
+};
+
+// allocates a value for the interpreter owning 'heap': young when the heap has a nursery,
+// on the general-purpose heap otherwise (uncharged when heap is nullptr)
+template <typename T, typename... Args>
+Ref<T> newObject(Heap* heap, Args&&... args) {
+	if (heap && heap->config.nursery) {
+		return heap->allocateYoung<T>(std::forward<Args>(args)...);
+	}
+
+	if (heap) {
+		return heap->allocateOld<T>(std::forward<Args>(args)...);
+	}
+
+	return makeRef<T>(std::forward<Args>(args)...);
+}
+
+// strings above the pretenuring size skip the nursery, as do old ones. Strings on the general
+// heap are charged their characters as well
+Ref<String> newString(Heap* heap, std::string value, bool old = false);
+
+// creates the environment for a function call, through the outer environment's heap when it has one
+EnvironmentRef newEnclosedEnvironment(EnvironmentRef outer);
+
+// whether the frame of a call to function fits in the memory limit of its interpreter; every
+// engine checks before making one, and returns a "memory limit exceeded" error when it doesn't
+inline bool callFits(Function* function) {
+	Heap* heap = function->env ? function->env->heap : nullptr;
+	return !heap || heap->quota().fits(sizeof(Environment));
+}
+
+
+#endif // !GC_HPP
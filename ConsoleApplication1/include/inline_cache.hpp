@@ -0,0 +1,42 @@
+#ifndef INLINE_CACHE_HPP
+#define INLINE_CACHE_HPP
+
+#include <cstddef>
+#include <iostream>
+#include "object.hpp"
+#include "ast.hpp"
+
+struct InlineCacheStats {
+	size_t identifierHits = 0;
+	size_t identifierMisses = 0;
+	size_t callHits = 0;
+	size_t callMisses = 0;
+
+	InlineCacheStats& operator+=(const InlineCacheStats& other) {
+		identifierHits += other.identifierHits;
+		identifierMisses += other.identifierMisses;
+		callHits += other.callHits;
+		callMisses += other.callMisses;
+		return *this;
+	}
+};
+
+// @brief the binding ident refers to from env, nullptr when there is none.
+// The node remembers how many environments up it resolved and the entry it found there, so
+// later lookups walk straight to that depth (only checking the nameMask of the environments
+// in between, in case one of them shadows the name) and reuse the entry when it's the same
+// environment again
+const ObjectRef* lookupIdentifier(Identifier* ident, Environment* env);
+
+// @brief fn as a Function, nullptr when it isn't one. site (may be nullptr) remembers the
+// code and arity it last called, and whether that code's parameters can be appended to a new
+// frame without looking each one up first; the call path reads that from site->cache, which
+// stays as it is while the site keeps calling the same code
+Function* resolveCallee(CallExpression* site, Object* fn);
+
+// sums the hit/miss counters of every cache under root
+InlineCacheStats collectInlineCacheStats(Node* root);
+void printInlineCacheStats(std::ostream& out, const InlineCacheStats& stats);
+
+
+#endif // !INLINE_CACHE_HPP
@@ -0,0 +1,72 @@
+#ifndef JIT_HPP
+#define JIT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+
+struct JitConfig {
+	bool enabled = false;      // tier up hot functions at all
+	uint32_t threshold = 1000; // interpreted calls of a function body before it is compiled
+	size_t maxDepth = 10000;   // nested native calls before falling back to the interpreter
+	bool perfMap = true;       // describe compiled code in /tmp/perf-<pid>.map for perf
+};
+
+struct JitStats {
+	size_t compiled = 0;
+	size_t rejected = 0;
+	size_t nativeCalls = 0;
+	size_t bailouts = 0; // native calls that gave up and were interpreted instead
+};
+
+// counted per thread rather than per interpreter: an interpreter runs on one thread at a time
+extern thread_local JitStats jitStats;
+
+// @brief x86-64 machine code for one function body, in its own executable mapping.
+// Only bodies made of integer and boolean arithmetic, ifs, lets, and calls to the function
+// itself are compiled. Such a body has no side effects, so whenever the code can't produce
+// what eval would (a division by zero, arguments that aren't integers, recursion deeper
+// than JitConfig::maxDepth) it gives up and the call is simply interpreted from the start
+class JitCode {
+public:
+	// nullptr when the body isn't integer-only, or on a platform without the JIT
+	static std::shared_ptr<JitCode> compile(Function* function, const JitConfig& config);
+
+	JitCode(const JitCode&) = delete;
+	JitCode& operator=(const JitCode&) = delete;
+	~JitCode();
+
+	// the result of calling function with args, nullptr when the call has to be interpreted
+	ObjectRef call(Function* function, Arguments args, const JitConfig& config);
+
+	const uint8_t* code() const {
+		return memory;
+	};
+	size_t size() const {
+		return length;
+	};
+
+private:
+	JitCode() = default;
+
+	using Entry = int64_t(*)(const int64_t* args, int64_t* bailed, int64_t depth);
+
+	uint8_t* memory = nullptr;
+	size_t length = 0;
+	size_t mapped = 0;
+	Entry entry = nullptr;
+	size_t arity = 0;
+	bool returnsBoolean = false;
+	std::string selfName; // name the body calls itself by, checked on every entry
+};
+
+// @brief called by applyFunction before interpreting a call, with the settings of the interpreter
+// making it. Counts calls to the body and compiles it once it's hot; nullptr when the call has to
+// be interpreted
+ObjectRef jitCall(Function* function, Arguments args, const JitConfig& config);
+
+
+#endif // !JIT_HPP
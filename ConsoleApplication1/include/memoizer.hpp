@@ -0,0 +1,85 @@
+#ifndef MEMOIZER_HPP
+#define MEMOIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+
+struct MemoConfig {
+	bool enabled = false;     // memoize calls of pure functions at all
+	size_t maxEntries = 4096; // results kept per function, the least recently used go first
+};
+
+struct MemoStats {
+	size_t hits = 0;
+	size_t misses = 0;
+	size_t evictions = 0;
+	size_t flushes = 0; // tables emptied because a global name was bound again
+};
+
+// per thread, like jitStats
+extern thread_local MemoStats memoStats;
+
+// @brief whether calls of a function with this body depend only on their arguments and the
+// names they look up, so that equal arguments give equal results. Monkey has no mutation and no
+// builtins, so the only way a body can fail that is by creating functions: every call would
+// return or pass on a new closure over its own environment. Cached on the body
+bool isPure(BlockStatement* body);
+
+// @brief results of calls of one function, by their arguments, least recently used last.
+// Only functions defined in an outermost environment are memoized: their free names are looked
+// up there, where anything bound stays bound, so a result can only go stale when one of them is
+// bound again. The table is emptied whenever the rebinds of that environment have moved since it
+// was filled
+class MemoTable {
+public:
+	// outermost: the environment the function is defined in, nullptr for a table never flushed
+	explicit MemoTable(const Environment* outermost = nullptr) : scope(outermost), rebinds(outermost ? outermost->rebinds : 0) {};
+
+	// nullptr when there is no result for key
+	ObjectRef find(const std::string& key);
+	// evicts the least recently used results past maxEntries
+	void insert(const std::string& key, ObjectRef value, size_t maxEntries);
+
+	size_t size() const {
+		return order.size();
+	};
+
+private:
+	using Entry = std::pair<std::string, ObjectRef>;
+
+	std::list<Entry> order; // most recently used first
+	std::unordered_map<std::string, std::list<Entry>::iterator> entries;
+	const Environment* scope; // kept alive by the function holding the table
+	uint64_t rebinds;
+
+	void flushIfStale();
+};
+
+// @brief a call that may be answered from, or recorded in, its function's MemoTable
+struct MemoizedCall {
+	ObjectRef function; // nullptr when the call can't be memoized
+	std::string key;    // the arguments, encoded
+};
+
+// the memo entry for calling fn with args, with function unset when fn isn't pure, isn't defined in an
+// outermost environment, or an argument isn't an integer, boolean, string or null
+MemoizedCall memoizedCall(const ObjectRef& fn, Arguments args);
+
+// the result recorded for call, nullptr when there is none
+ObjectRef memoLookup(const MemoizedCall& call);
+
+// records result for call; errors, and values other than integers, booleans, strings and null, are not kept
+void memoStore(const MemoizedCall& call, const ObjectRef& result, const MemoConfig& config);
+
+void printMemoStats(std::ostream& out, const MemoStats& stats);
+
+
+#endif // !MEMOIZER_HPP
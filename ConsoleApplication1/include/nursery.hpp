@@ -0,0 +1,85 @@
+#ifndef NURSERY_HPP
+#define NURSERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include "quota.hpp"
+
+// @brief counters describing nursery activity, exposed through Heap::nurseryStats()
+struct NurseryStats {
+	size_t allocations = 0;     // objects bump-allocated in the young generation
+	size_t promotions = 0;      // young objects copied to the old space because they survived
+	size_t chunksAllocated = 0; // fresh chunks requested from the system
+	size_t chunksRecycled = 0;  // chunks reused once every object in them died
+};
+
+// @brief young generation: a bump-pointer allocator over fixed-size, size-aligned chunks.
+// Objects are never freed individually; each chunk counts its live objects and is recycled as
+// a whole when that count drops to zero, which is the common case for temporaries that die
+// within one expression. Objects that survive (see Heap::promote) are copied to the old space
+// so they don't pin a chunk. Chunks still holding objects when the nursery is destroyed are
+// released by their last object.
+class Nursery {
+public:
+	static constexpr size_t chunkSize = 64 * 1024; // chunks are aligned to their size, see release()
+
+	// chunks taken from the system are charged to quota, when there is one
+	explicit Nursery(MemoryQuota* quota = nullptr) : current(nullptr), quota(quota) {};
+	~Nursery();
+
+	Nursery(const Nursery&) = delete;
+	Nursery& operator=(const Nursery&) = delete;
+
+	// bump-pointer fast path; falls back to allocateSlow when the current chunk is full
+	void* allocate(size_t bytes, size_t alignment) {
+		if (current) {
+			size_t offset = (current->used + alignment - 1) & ~(alignment - 1);
+			if (offset + bytes <= chunkSize) {
+				current->used = offset + bytes;
+				current->live++;
+				nurseryStats.allocations++;
+				return reinterpret_cast<char*>(current) + offset;
+			}
+		}
+
+		return allocateSlow(bytes, alignment);
+	}
+
+	static void release(void* ptr) {
+		// chunks are aligned to their size, so the owning chunk is found by masking the address
+		auto* chunk = reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(chunkSize - 1));
+		if (--chunk->live == 0) {
+			chunkEmptied(chunk);
+		}
+	}
+
+	const NurseryStats& stats() const { return nurseryStats; };
+	void countPromotion() { nurseryStats.promotions++; };
+
+private:
+	struct Chunk {
+		Nursery* owner;     // nullptr once the nursery is gone
+		MemoryQuota* quota; // credited when the chunk is freed
+		size_t used;        // bump offset from the start of the chunk
+		size_t live;        // objects allocated here and not released yet
+	};
+
+	static constexpr size_t maxFreeChunks = 16;
+
+	void* allocateSlow(size_t bytes, size_t alignment);
+	static void chunkEmptied(Chunk* chunk);
+	Chunk* takeChunk();
+	void recycle(Chunk* chunk);
+	static void freeChunk(Chunk* chunk);
+
+	Chunk* current;
+	MemoryQuota* quota;
+	std::vector<Chunk*> chunks;     // every chunk this nursery owns
+	std::vector<Chunk*> freeChunks; // empty chunks ready for reuse
+	NurseryStats nurseryStats;
+};
+
+
+#endif // !NURSERY_HPP
@@ -1,184 +1,495 @@
-﻿#ifndef OBJECT_HPP
-#define OBJECT_HPP
-
-#include <iostream>
-#include <sstream>
-#include <memory>
-#include <vector>
-#include <string>
-#include <utility>
-#include <unordered_map>
-#include "ast.hpp"
-
-using objectType = std::string;
-
-namespace objectTypes {
-	const objectType INTEGER_OBJ = "INTEGER";
-	const objectType BOOLEAN_OBJ = "BOOLEAN";
-	const objectType NULL_OBJ = "NULL";
-	const objectType RETURN_OBJ = "RETURN_VALUE";
-	const objectType ERROR_OBJ = "ERROR";
-	const objectType FUNCTION_OBJ = "FUNCTION";
-	const objectType STRING_OBJ = "STRING";
-}
-
-class Object {
-public:
-	virtual ~Object() = default;
-
-	virtual objectType Type() const = 0;
-	virtual std::string Inspect() const = 0;
-};
-
-class Integer : public Object {
-public:
-	int64_t value;
-
-	Integer(int64_t val) : value(val) {};
-	objectType Type() const override {
-		return objectTypes::INTEGER_OBJ;
-	}
-
-	std::string Inspect() const override {
-		return std::to_string(value);
-	}
-};
-
-class Boolean : public Object {
-public:
-	bool value;
-
-	Boolean(bool val) : value(val) {};
-
-	objectType Type() const override {
-		return objectTypes::BOOLEAN_OBJ;
-	}
-
-	std::string Inspect() const override {
-		return value ? "true" : "false";
-	}
-};
-
-class String : public Object {
-public:
-	std::string value;
-
-	String(std::string val) : value(val) {};
-
-	objectType Type() const override {
-		return objectTypes::STRING_OBJ;
-	}
-
-	std::string Inspect() const override {
-		return value;
-	}
-};
-
-class Null : public Object {
-public:
-	objectType Type() const override {
-		return objectTypes::NULL_OBJ;
-	}
-
-	std::string Inspect() const override {
-		return "null";
-	}
-};
-
-class ReturnValue : public Object {
-public:
-	std::unique_ptr<Object> value;
-
-	ReturnValue(std::unique_ptr<Object> val) : value(std::move(val)) {};
-	
-	objectType Type() const override {
-		return objectTypes::RETURN_OBJ;
-	}
-
-	std::string Inspect() const override {
-		return value->Inspect();
-	}
-};
-
-class Error : public Object {
-public:
-	std::string message;
-
-	Error(const std::string& mess) : message(mess) {};
-
-	objectType Type() const override {
-		return objectTypes::ERROR_OBJ;
-	};
-
-	std::string Inspect() const override {
-		return std::string("ERROR : ") + message;
-	};
-
-};
-
-class Environment {
-public:
-	std::unordered_map<std::string, std::shared_ptr<Object>> store;
-	std::shared_ptr<Environment> outer;
-
-	Environment() : outer(nullptr) {};
-
-	Environment(std::shared_ptr<Environment> out) : outer(out) {};
-
-	std::pair<std::shared_ptr<Object>, bool> getObject(const std::string& name) {
-		auto it = store.find(name);
-		if (it != store.end()) {
-			return { it->second, true };
-		}
-
-		if (outer != nullptr) {
-			return outer->getObject(name);
-		}
-
-		return { nullptr, false };
-	}
-
-	std::shared_ptr<Object> setObject(const std::string& name, std::shared_ptr<Object> val) {
-		store[name] = val;
-		return val;
-	}
-};
-
-class Function : public Object {
-public:
-	std::vector<Identifier*> parameters;
-	BlockStatement* body;
-	std::shared_ptr<Environment> env;
-
-	Function() : body(nullptr) {};
-
-	objectType Type() const override {
-		return objectTypes::FUNCTION_OBJ;
-	};
-
-	std::string Inspect() const override {
-		std::stringstream out;
-
-		out << "fn(";
-		for (size_t i = 0; i < parameters.size(); i++) {
-			if (parameters[i]) {  // ← Check for nullptr!
-				out << parameters[i]->string();
-			}
-			if (i < parameters.size() - 1) {
-				out << ", ";
-			}
-		}
-		out << ") {\n";
-
-		if (body) {  // ← Check for nullptr!
-			out << body->string();
-		}
-
-		out << "\n}";
-
-		return out.str();
-	}
-};
-
-
-#endif // OBJECT_HPP
+﻿#ifndef OBJECT_HPP
+#define OBJECT_HPP
+
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include "ref.hpp"
+#include "quota.hpp"
+#include "ast.hpp"
+
+using objectType = std::string;
+
+namespace objectTypes {
+	const objectType INTEGER_OBJ = "INTEGER";
+	const objectType BOOLEAN_OBJ = "BOOLEAN";
+	const objectType NULL_OBJ = "NULL";
+	const objectType RETURN_OBJ = "RETURN_VALUE";
+	const objectType ERROR_OBJ = "ERROR";
+	const objectType FUNCTION_OBJ = "FUNCTION";
+	const objectType STRING_OBJ = "STRING";
+	const objectType TAIL_CALL_OBJ = "TAIL_CALL";
+	const objectType UPVALUE_OBJ = "UPVALUE";
+}
+
+// @brief dense index of the concrete object classes, for the operator dispatch tables
+enum class ObjectKind : uint8_t { Integer, Boolean, String, Null, ReturnValue, TailCall, Error, Function, Upvalue, Count };
+
+// the name Type() gives objects of kind; "NULL" for ObjectKind::Count, which stands for no object
+const objectType& kindName(ObjectKind kind);
+
+class Object : public RefCounted, public QuotaAllocated {
+public:
+	const ObjectKind tag; // set by the concrete class, so checking a kind is a load and a compare
+	bool young = false;   // allocated in the heap's nursery, see Heap::promote
+
+	virtual ~Object() = default;
+
+	ObjectKind kind() const {
+		return tag;
+	}
+
+	// the type's name, for messages and printing only; compare kind() instead
+	const objectType& Type() const {
+		return kindName(tag);
+	}
+
+	virtual std::string Inspect() const = 0;
+
+	// frees the object once its last ObjectRef is gone: back to the nursery when young, to the
+	// general heap otherwise. Virtual so that native code built by AotModule, which can't link
+	// against the interpreter, frees objects through the interpreter's own code
+	virtual void reclaim();
+
+protected:
+	explicit Object(ObjectKind kind) : tag(kind) {};
+};
+
+// values are immutable once created, so environments, call arguments and intermediate
+// results all share one instance through a reference-counted handle instead of copying it
+using ObjectRef = Ref<Object>;
+
+class Environment;
+using EnvironmentRef = Ref<Environment>;
+
+// @brief the arguments of a call, read where the caller keeps them: a vector, or the tree
+// walker's value stack. Only valid until the caller pushes or pops
+class Arguments {
+public:
+	Arguments(const std::vector<ObjectRef>& args) : first(args.data()), count(args.size()) {};
+	Arguments(const ObjectRef* first, size_t count) : first(first), count(count) {};
+
+	size_t size() const {
+		return count;
+	}
+
+	const ObjectRef& operator[](size_t i) const {
+		return first[i];
+	}
+
+	const ObjectRef* begin() const {
+		return first;
+	}
+
+	const ObjectRef* end() const {
+		return first + count;
+	}
+
+private:
+	const ObjectRef* first;
+	size_t count;
+};
+
+class Integer : public Object {
+public:
+	const int64_t value;
+
+	Integer(int64_t val) : Object(ObjectKind::Integer), value(val) {};
+
+	std::string Inspect() const override {
+		return std::to_string(value);
+	}
+};
+
+// @brief integer arithmetic as every engine computes it: in two's complement, wrapping around on
+// overflow, like the JIT's machine instructions. Boxed, unboxed and native code all go through these
+inline int64_t wrappingAdd(int64_t left, int64_t right) {
+	return static_cast<int64_t>(static_cast<uint64_t>(left) + static_cast<uint64_t>(right));
+}
+
+inline int64_t wrappingSubtract(int64_t left, int64_t right) {
+	return static_cast<int64_t>(static_cast<uint64_t>(left) - static_cast<uint64_t>(right));
+}
+
+inline int64_t wrappingMultiply(int64_t left, int64_t right) {
+	return static_cast<int64_t>(static_cast<uint64_t>(left) * static_cast<uint64_t>(right));
+}
+
+inline int64_t wrappingNegate(int64_t value) {
+	return static_cast<int64_t>(0 - static_cast<uint64_t>(value));
+}
+
+// divisor must not be 0; INT64_MIN / -1 wraps to INT64_MIN instead of trapping
+inline int64_t wrappingDivide(int64_t left, int64_t divisor) {
+	return divisor == -1 ? wrappingNegate(left) : left / divisor;
+}
+
+class Boolean : public Object {
+public:
+	const bool value;
+
+	Boolean(bool val) : Object(ObjectKind::Boolean), value(val) {};
+
+	std::string Inspect() const override {
+		return value ? "true" : "false";
+	}
+};
+
+class String : public Object {
+public:
+	const std::string value;
+
+	String(std::string val) : Object(ObjectKind::String), value(std::move(val)) {};
+
+	std::string Inspect() const override {
+		return value;
+	}
+};
+
+class Null : public Object {
+public:
+	Null() : Object(ObjectKind::Null) {};
+
+	std::string Inspect() const override {
+		return "null";
+	}
+};
+
+class ReturnValue : public Object {
+public:
+	ObjectRef value;
+
+	ReturnValue(ObjectRef val) : Object(ObjectKind::ReturnValue), value(std::move(val)) {};
+
+	std::string Inspect() const override {
+		return value->Inspect();
+	}
+};
+
+// @brief a call in tail position, handed back to the caller's applyFunction instead of being made,
+// so the caller reuses its native frame for it. Never escapes a function body.
+class TailCall : public Object {
+public:
+	ObjectRef function;
+	std::vector<ObjectRef> arguments;
+	CallExpression* site; // the call being made, for its inline cache
+
+	TailCall(ObjectRef fn, std::vector<ObjectRef> args, CallExpression* callSite)
+		: Object(ObjectKind::TailCall), function(std::move(fn)), arguments(std::move(args)), site(callSite) {};
+
+	std::string Inspect() const override {
+		return "tail call";
+	}
+};
+
+// @brief what an Error is about, so that evaluation can create one without building its message
+enum class ErrorCode : uint8_t {
+	NotAFunction,           // left: the callee's kind
+	IdentifierNotFound,     // name
+	UnknownPrefixOperator,  // op, right
+	PrefixTypeMismatch,     // right: the operand of a minus that isn't an integer
+	DivisionByZero,
+	UnknownIntegerOperator, // op
+	UnknownStringOperator,  // op
+	OperandMismatch,        // op, left, right: operands no operator kernel takes
+	StackDepthExceeded,
+	MemoryLimitExceeded,
+	Custom,                 // any other message, given as is
+};
+
+class Error : public Object {
+public:
+	const ErrorCode code;
+	const Operator op = Operator::Unknown;
+	const ObjectKind left = ObjectKind::Count;  // operand kinds, ObjectKind::Count when there was no object
+	const ObjectKind right = ObjectKind::Count;
+	const std::string name;
+
+	Error(const std::string& mess) : Object(ObjectKind::Error), code(ErrorCode::Custom), formatted(true), text(mess) {};
+	Error(ErrorCode code) : Object(ObjectKind::Error), code(code) {};
+	Error(ErrorCode code, Operator op, ObjectKind left, ObjectKind right) : Object(ObjectKind::Error), code(code), op(op), left(left), right(right) {};
+	Error(ErrorCode code, std::string name) : Object(ObjectKind::Error), code(code), name(std::move(name)) {};
+
+	// formatted from the code on first use, as most errors are only ever checked for
+	const std::string& message() const;
+
+	std::string Inspect() const override {
+		return std::string("ERROR : ") + message();
+	};
+
+private:
+	mutable bool formatted = false;
+	mutable std::string text;
+};
+
+// @brief a binding captured by a closure, shared by the environment that binds it and the
+// closure's, so a let on either side is seen by both (see closureEnvironment). Only ever
+// found in Bindings, never as the value of an expression
+class Upvalue : public Object {
+public:
+	ObjectRef value; // nullptr until the let it was made for binds it
+
+	Upvalue(ObjectRef val) : Object(ObjectKind::Upvalue), value(std::move(val)) {};
+
+	std::string Inspect() const override {
+		return value ? value->Inspect() : "null";
+	}
+};
+
+// the kind of obj, ObjectKind::Count for no object
+inline ObjectKind kindOf(const Object* obj) {
+	return obj ? obj->kind() : ObjectKind::Count;
+}
+
+class Heap;
+class MemoTable;
+
+// @brief the bindings of one environment. Most environments are call frames binding a couple of
+// parameters and lets, so the first inlineCapacity bindings live in the environment itself and are
+// found by comparing symbols in turn; a scope binding more than that (the REPL's global one, say)
+// moves them all to an open-addressing table, which doubles when three quarters full.
+// Bindings are never removed, and entries only move when insert says so
+class Bindings {
+public:
+	struct Entry {
+		Symbol symbol = noSymbol;
+		ObjectRef value;
+	};
+
+	struct Inserted {
+		ObjectRef* value;
+		bool inserted; // symbol wasn't bound before
+		bool moved;    // the other entries moved to make room
+	};
+
+	static constexpr size_t inlineCapacity = 6;
+
+	Bindings() = default;
+	Bindings(const Bindings&) = delete;
+	Bindings& operator=(const Bindings&) = delete;
+
+	// the value bound to symbol, nullptr when there is none
+	ObjectRef* find(Symbol symbol) {
+		if (table) {
+			Entry& entry = slot(symbol);
+			return entry.symbol == symbol ? &entry.value : nullptr;
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			if (small[i].symbol == symbol) {
+				return &small[i].value;
+			}
+		}
+		return nullptr;
+	}
+
+	// the entry of symbol, added with no value when there is none
+	Inserted insert(Symbol symbol);
+
+	// binds symbol, which the caller knows isn't bound yet, while the bindings still fit inline
+	void append(Symbol symbol, ObjectRef value) {
+		small[count].symbol = symbol;
+		small[count].value = std::move(value);
+		count++;
+	}
+
+	// drops every binding, and the table if there is one
+	void clear();
+
+	size_t size() const {
+		return count;
+	}
+
+	// memory held outside the environment
+	size_t tableBytes() const {
+		return capacity * sizeof(Entry);
+	}
+
+	// visits the bound entries only
+	class Iterator {
+	public:
+		Iterator(Entry* at, Entry* end) : at(at), end(end) {
+			skipFree();
+		}
+
+		Entry& operator*() const {
+			return *at;
+		}
+
+		Iterator& operator++() {
+			++at;
+			skipFree();
+			return *this;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return at != other.at;
+		}
+
+	private:
+		Entry* at;
+		Entry* end;
+
+		void skipFree() {
+			while (at != end && at->symbol == noSymbol) {
+				++at;
+			}
+		}
+	};
+
+	Iterator begin() {
+		Entry* entries = table ? table.get() : small;
+		return Iterator(entries, entries + (table ? capacity : count));
+	}
+
+	Iterator end() {
+		Entry* last = table ? table.get() + capacity : small + count;
+		return Iterator(last, last);
+	}
+
+private:
+	Entry small[inlineCapacity];
+	size_t count = 0;
+	std::unique_ptr<Entry[]> table; // nullptr while the bindings fit in small
+	size_t capacity = 0;            // of table, a power of two
+
+	// the entry of symbol in table, or the free one it would go to
+	Entry& slot(Symbol symbol) const {
+		size_t mask = capacity - 1;
+		for (size_t i = (uint64_t(symbol) * 0x9E3779B97F4A7C15ull) >> 32 & mask;; i = (i + 1) & mask) {
+			Entry& entry = table[i];
+			if (entry.symbol == symbol || entry.symbol == noSymbol) {
+				return entry;
+			}
+		}
+	}
+
+	void grow();
+};
+
+class Environment : public RefCounted, public QuotaAllocated {
+public:
+	static constexpr size_t untracked = SIZE_MAX;
+
+	Bindings store;
+	EnvironmentRef outer;
+	Heap* heap; // heap its values are allocated on, inherited from outer; nullptr for none
+	size_t trackedAt = untracked; // index in heap's registry, when the collector tracks it (see Heap::newEnvironment)
+	bool stacked = false; // allocated on the frame stack, see newStackFrame
+	bool captured; // reachable beyond the current call (global, or closed over): bindings get promoted
+	uint64_t serial; // unique per environment and renewed when its entries move, checked by the identifier inline caches
+	uint64_t nameMask = 0; // symbolBit of every symbol bound here
+
+	// how often a let has bound one of its names again, counted in outermost environments only:
+	// that is all that can change what the free names of their functions refer to (see MemoTable)
+	uint64_t rebinds = 0;
+
+	Environment() : outer(nullptr), heap(nullptr), captured(false), serial(nextSerial()) {};
+
+	Environment(EnvironmentRef out) : outer(out), heap(out ? out->heap : nullptr), captured(false),
+		serial(nextSerial()) {};
+
+	Environment(const Environment&) = delete;
+	Environment& operator=(const Environment&) = delete;
+
+	// leaves its heap's registry
+	~Environment();
+
+	// frees the environment once its last EnvironmentRef is gone: back to the frame stack when
+	// stacked, crediting its heap's quota, and to the general heap otherwise
+	void reclaim();
+
+	std::pair<ObjectRef, bool> getObject(Symbol symbol) {
+		for (Environment* env = this; env; env = env->outer.get()) {
+			if (ObjectRef* value = env->store.find(symbol)) {
+				if (kindOf(value->get()) != ObjectKind::Upvalue) {
+					return { *value, true };
+				}
+
+				// an upvalue no let has filled yet binds nothing
+				if (const ObjectRef& captured = static_cast<Upvalue*>(value->get())->value) {
+					return { captured, true };
+				}
+			}
+		}
+
+		return { nullptr, false };
+	}
+
+	std::pair<ObjectRef, bool> getObject(const std::string& name) {
+		Symbol symbol = findSymbol(name);
+		if (symbol == noSymbol) {
+			return { nullptr, false };
+		}
+
+		return getObject(symbol);
+	}
+
+	ObjectRef setObject(Symbol symbol, ObjectRef val);
+
+	// the upvalue of symbol's binding here, for a closure to capture. The first time, the bound
+	// value moves into a new upvalue; a name not bound yet gets an empty one for its coming let
+	Ref<Upvalue> upvalue(Symbol symbol);
+
+	// drops every binding and makes this a new environment enclosed by out, see Heap::recycle
+	void reset(EnvironmentRef out);
+
+	ObjectRef setObject(const std::string& name, ObjectRef val) {
+		return setObject(intern(name), std::move(val));
+	}
+
+private:
+	static uint64_t nextSerial();
+};
+
+class Function : public Object {
+public:
+	std::vector<Identifier*> parameters;
+	BlockStatement* body;
+	std::shared_ptr<const FunctionCode> code; // owns parameters and body
+	EnvironmentRef env;
+	std::shared_ptr<MemoTable> memo; // results of earlier calls, once memoized, see memoizedCall
+
+	Function() : Object(ObjectKind::Function), body(nullptr) {};
+
+	std::string Inspect() const override {
+		std::stringstream out;
+
+		out << "fn(";
+		for (size_t i = 0; i < parameters.size(); i++) {
+			if (parameters[i]) {  // ← Check for nullptr!
+				out << parameters[i]->string();
+			}
+			if (i < parameters.size() - 1) {
+				out << ", ";
+			}
+		}
+		out << ") {\n";
+
+		if (body) {  // ← Check for nullptr!
+			out << body->string();
+		}
+
+		out << "\n}";
+
+		return out.str();
+	}
+};
+
+// @brief a value handed to another thread. ObjectRef counts aren't atomic, so a value never
+// crosses threads itself: shareValue copies it into this atomically counted handle, and
+// unshareValue copies it back into an ObjectRef of the receiving thread's interpreter
+using SharedValue = std::shared_ptr<const Object>;
+
+// nullptr for what can't be copied: functions, which hold environments of the thread that made
+// them, and the control-flow wrappers
+SharedValue shareValue(const Object* value);
+ObjectRef unshareValue(const SharedValue& value);
+
+
+#endif // OBJECT_HPP
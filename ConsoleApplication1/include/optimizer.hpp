@@ -0,0 +1,99 @@
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ast.hpp"
+
+// @brief a rewrite of the whole program, run between parseProgram and eval
+class Pass {
+public:
+	virtual ~Pass() = default;
+	virtual std::string name() const = 0;
+
+	// rewrites the program in place, returns how many rewrites were made
+	virtual size_t run(Program& program) = 0;
+
+	// details of the rewrites made so far, printed after the pass's statistics
+	virtual void printReport(std::ostream&) const {};
+};
+
+// @brief replaces prefix and infix expressions over literals by their value, and ifs with a
+// literal condition by the branch that would be taken. Anything that would evaluate to an
+// error (5 / 0, -true) is left for eval so the message stays the same
+class ConstantFolding : public Pass {
+public:
+	std::string name() const override {
+		return "constant-folding";
+	};
+	size_t run(Program& program) override;
+};
+
+// @brief drops statements that can't run (after a return) or whose value is thrown away
+// without side effects (a literal that isn't the last statement of its block)
+class DeadCodeElimination : public Pass {
+public:
+	std::string name() const override {
+		return "dead-code-elimination";
+	};
+	size_t run(Program& program) override;
+};
+
+// @brief expands calls to small helpers bound by let, like add(x, 1) for
+// let add = fn(a, b) { a + b }, into the helper's body with the arguments substituted.
+// Only helpers whose body is one expression over their parameters (no calls, no free names)
+// of at most maxBodyNodes nodes are inlined, and only at sites whose arguments are literals
+// or names known to be bound, so substituting them can't change what fails or in which order.
+// The call is kept: eval uses the expansion only while the callee is still that helper
+class FunctionInlining : public Pass {
+public:
+	static constexpr size_t maxBodyNodes = 16;
+
+	std::string name() const override {
+		return "function-inlining";
+	};
+	size_t run(Program& program) override;
+	void printReport(std::ostream& out) const override;
+
+private:
+	std::vector<std::string> sites; // "call -> expansion"
+};
+
+struct PassStats {
+	std::string name;
+	size_t runs = 0;
+	size_t rewrites = 0;
+	size_t nodesBefore = 0; // summed over every run
+	size_t nodesAfter = 0;
+	std::chrono::nanoseconds time{ 0 };
+};
+
+// @brief runs a list of passes over each program it's given and keeps per-pass statistics
+// level 0 = no passes, level 1 = constant folding then dead-code elimination,
+// level 2 = level 1, function inlining, then type inference (see type_inference.hpp)
+class PassManager {
+public:
+	explicit PassManager(int level = 1);
+
+	void addPass(std::unique_ptr<Pass> pass);
+	void run(Program& program);
+
+	const std::vector<PassStats>& stats() const {
+		return passStats;
+	};
+	void printStats(std::ostream& out) const;
+
+private:
+	std::vector<std::unique_ptr<Pass>> passes;
+	std::vector<PassStats> passStats;
+};
+
+// number of AST nodes under (and including) node
+size_t countNodes(Node* node);
+
+
+#endif // !OPTIMIZER_HPP
@@ -0,0 +1,143 @@
+#ifndef QUOTA_HPP
+#define QUOTA_HPP
+
+#include <cstddef>
+#include <new>
+
+// @brief counters of an interpreter's memory quota, exposed through Heap::memoryStats()
+struct MemoryStats {
+	size_t limit = 0;       // bytes, 0 = unlimited
+	size_t bytesInUse = 0;  // charged and not freed yet
+	size_t peakBytes = 0;
+	size_t allocations = 0; // charges made
+	size_t frees = 0;       // charges credited back
+	size_t refusals = 0;    // calls and concatenations stopped with "memory limit exceeded"
+};
+
+// @brief byte budget of one interpreter. Its heap charges what it allocates here: objects on the
+// general heap with the characters of their strings, environments and call frames, and nursery
+// chunks; each is credited back when freed. Allocations themselves never fail: before what can grow
+// without bound (a call, a string concatenation) the evaluator asks fits(), and returns an Error
+// when the answer is no. Like a nursery chunk, a quota whose heap is gone is freed by the last
+// thing still charged to it
+class MemoryQuota {
+public:
+	explicit MemoryQuota(size_t limit) {
+		quotaStats.limit = limit;
+	};
+
+	MemoryQuota(const MemoryQuota&) = delete;
+	MemoryQuota& operator=(const MemoryQuota&) = delete;
+
+	void charge(size_t bytes) {
+		quotaStats.allocations++;
+		grow(bytes);
+	}
+
+	void credit(size_t bytes) {
+		quotaStats.bytesInUse -= bytes;
+		quotaStats.frees++;
+		if (orphaned && quotaStats.frees == quotaStats.allocations) {
+			delete this;
+		}
+	}
+
+	// whether bytes more stay within the limit; a no is counted as a refusal
+	bool fits(size_t bytes) {
+		if (quotaStats.limit == 0 || quotaStats.bytesInUse + bytes <= quotaStats.limit) {
+			return true;
+		}
+
+		quotaStats.refusals++;
+		return false;
+	}
+
+	// called by the heap going away; frees the quota now, or with the last charge still out
+	void orphan() {
+		orphaned = true;
+		if (quotaStats.frees == quotaStats.allocations) {
+			delete this;
+		}
+	}
+
+	const MemoryStats& stats() const {
+		return quotaStats;
+	};
+
+	// general-heap memory for an object, charged to quota unless that is nullptr. A header in
+	// front of the object remembers what to credit to which quota when release frees it
+	static void* allocate(size_t bytes, MemoryQuota* quota) {
+		auto* header = static_cast<Header*>(::operator new(sizeof(Header) + bytes));
+		header->quota = quota;
+		header->bytes = bytes;
+		if (quota) {
+			quota->charge(bytes);
+		}
+		return header + 1;
+	}
+
+	// adds bytes the object at ptr holds outside of itself (a string's characters) to its charge
+	static void chargeMore(void* ptr, size_t bytes) {
+		Header* header = static_cast<Header*>(ptr) - 1;
+		if (header->quota) {
+			header->quota->grow(bytes);
+			header->bytes += bytes;
+		}
+	}
+
+	static void release(void* ptr) {
+		Header* header = static_cast<Header*>(ptr) - 1;
+		if (header->quota) {
+			header->quota->credit(header->bytes);
+		}
+		::operator delete(header);
+	}
+
+private:
+	struct alignas(alignof(std::max_align_t)) Header {
+		MemoryQuota* quota;
+		size_t bytes;
+	};
+
+	~MemoryQuota() = default;
+
+	void grow(size_t bytes) {
+		quotaStats.bytesInUse += bytes;
+		if (quotaStats.bytesInUse > quotaStats.peakBytes) {
+			quotaStats.peakBytes = quotaStats.bytesInUse;
+		}
+	}
+
+	bool orphaned = false;
+	MemoryStats quotaStats;
+};
+
+// @brief base of the classes allocated through MemoryQuota::allocate: new (quota) T(...) charges
+// quota, a plain new T(...) charges nothing, and delete credits whatever was charged. Placement
+// new still puts objects in nursery chunks and on the frame stack
+struct QuotaAllocated {
+	static void* operator new(size_t bytes) {
+		return MemoryQuota::allocate(bytes, nullptr);
+	}
+
+	static void* operator new(size_t bytes, MemoryQuota* quota) {
+		return MemoryQuota::allocate(bytes, quota);
+	}
+
+	static void* operator new(size_t, void* place) {
+		return place;
+	}
+
+	static void operator delete(void* ptr) {
+		MemoryQuota::release(ptr);
+	}
+
+	static void operator delete(void* ptr, MemoryQuota*) {
+		MemoryQuota::release(ptr);
+	}
+
+	static void operator delete(void*, void*) {}
+};
+
+
+#endif // !QUOTA_HPP
@@ -0,0 +1,179 @@
+#ifndef REF_HPP
+#define REF_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// @brief base of what an interpreter shares through Ref: values and environments. One
+// interpreter instance only ever runs on one thread, and shares none of them with another (each
+// has its own heap, frame stack and value stack), so the count is a plain integer kept in the
+// object, and taking or dropping a reference is an increment or a decrement instead of the locked
+// instructions on a separate control block that std::shared_ptr needs. Values handed to another
+// thread go through shareValue instead
+class RefCounted {
+public:
+	RefCounted() = default;
+	RefCounted(const RefCounted&) {}; // a copy starts with no references of its own
+	RefCounted& operator=(const RefCounted&) { return *this; };
+
+	// handles held, for the collector's count of references from outside the graph
+	uint32_t refCount() const {
+		return refs;
+	}
+
+private:
+	mutable uint32_t refs = 0;
+
+	template <typename T>
+	friend class Ref;
+};
+
+// @brief owning handle to a RefCounted T. When the last one goes away it calls ptr->reclaim(),
+// which gives the memory back to wherever T was allocated: the nursery, the frame stack or the
+// general heap. Any T* can be turned into a handle again, as the count lives in the object
+template <typename T>
+class Ref {
+public:
+	Ref() : ptr(nullptr) {};
+	Ref(std::nullptr_t) : ptr(nullptr) {};
+
+	explicit Ref(T* p) : ptr(p) {
+		retain();
+	}
+
+	Ref(const Ref& other) : ptr(other.ptr) {
+		retain();
+	}
+
+	Ref(Ref&& other) noexcept : ptr(other.ptr) {
+		other.ptr = nullptr;
+	}
+
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	Ref(const Ref<U>& other) : ptr(other.get()) {
+		retain();
+	}
+
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	Ref(Ref<U>&& other) noexcept : ptr(other.ptr) {
+		other.ptr = nullptr;
+	}
+
+	~Ref() {
+		drop(ptr);
+	}
+
+	Ref& operator=(const Ref& other) {
+		T* old = ptr;
+		ptr = other.ptr;
+		retain();
+		drop(old);
+		return *this;
+	}
+
+	Ref& operator=(Ref&& other) noexcept {
+		if (this != &other) {
+			T* old = ptr;
+			ptr = other.ptr;
+			other.ptr = nullptr;
+			drop(old);
+		}
+		return *this;
+	}
+
+	// drops the reference; the handle is already empty when the object is reclaimed
+	void reset() {
+		T* old = ptr;
+		ptr = nullptr;
+		drop(old);
+	}
+
+	T* get() const {
+		return ptr;
+	}
+
+	T* operator->() const {
+		return ptr;
+	}
+
+	T& operator*() const {
+		return *ptr;
+	}
+
+	explicit operator bool() const {
+		return ptr != nullptr;
+	}
+
+	long use_count() const {
+		return ptr ? static_cast<long>(ptr->refs) : 0;
+	}
+
+	void swap(Ref& other) noexcept {
+		std::swap(ptr, other.ptr);
+	}
+
+private:
+	T* ptr;
+
+	void retain() const {
+		if (ptr) {
+			++ptr->refs;
+		}
+	}
+
+	static void drop(T* p) {
+		if (p && --p->refs == 0) {
+			p->reclaim();
+		}
+	}
+
+	template <typename U>
+	friend class Ref;
+};
+
+template <typename T, typename U>
+bool operator==(const Ref<T>& left, const Ref<U>& right) {
+	return left.get() == right.get();
+}
+
+template <typename T, typename U>
+bool operator!=(const Ref<T>& left, const Ref<U>& right) {
+	return left.get() != right.get();
+}
+
+template <typename T>
+bool operator==(const Ref<T>& ref, std::nullptr_t) {
+	return !ref;
+}
+
+template <typename T>
+bool operator!=(const Ref<T>& ref, std::nullptr_t) {
+	return static_cast<bool>(ref);
+}
+
+// a T on the general heap
+template <typename T, typename... Args>
+Ref<T> makeRef(Args&&... args) {
+	return Ref<T>(new T(std::forward<Args>(args)...));
+}
+
+// ref as a handle to T, which it must point to
+template <typename T, typename U>
+Ref<T> staticRefCast(const Ref<U>& ref) {
+	return Ref<T>(static_cast<T*>(ref.get()));
+}
+
+namespace std {
+	template <typename T>
+	struct hash<Ref<T>> {
+		size_t operator()(const Ref<T>& ref) const {
+			return hash<T*>()(ref.get());
+		}
+	};
+}
+
+
+#endif // !REF_HPP
@@ -1,9 +1,36 @@
-#ifndef REPL_HPP
-#define REPL_HPP
-#include <iostream>
-
-// 
-void Start(std::istream& in, std::ostream& out);
-
-
-#endif 
+#ifndef REPL_HPP
+#define REPL_HPP
+#include <iostream>
+#include "stack_machine.hpp"
+#include "aot.hpp"
+#include "jit.hpp"
+#include "specializer.hpp"
+#include "memoizer.hpp"
+
+// @brief which engine runs each line; all of them share the session's environments and objects
+enum class Engine {
+	Tree,      // eval
+	HeapStack, // evalOnHeapStack
+	Closures,  // compile, then run the compiled closures
+	Native,    // AotModule::build, then run the shared object; every line is a separate build
+};
+
+struct ReplOptions {
+	Engine engine = Engine::Tree;
+	StackMachineConfig stackMachine;
+	AotOptions aot;
+	JitConfig jit; // tree walker only: tier hot integer functions up to machine code
+	SpecializerConfig specializer; // tree walker only: call residual functions for constant arguments
+	MemoConfig memo; // tree walker only: answer repeated calls of pure functions from a cache
+	int optimizationLevel = 1; // PassManager level each line is run through before evaluation
+	size_t memoryLimit = 0;    // bytes the session may hold at once, 0 = unlimited; see MemoryQuota
+	bool passStats = false;    // print the per-pass statistics when the input ends
+	bool cacheStats = false;   // print the inline cache hit/miss counters when the input ends
+	bool typeStats = false;    // print how many expressions type inference typed (needs -O2)
+};
+
+// 
+void Start(std::istream& in, std::ostream& out, const ReplOptions& options = ReplOptions());
+
+
+#endif 
@@ -0,0 +1,56 @@
+#ifndef SPECIALIZER_HPP
+#define SPECIALIZER_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "object.hpp"
+#include "ast.hpp"
+
+struct SpecializerConfig {
+	bool enabled = false;      // call through specializations at all
+	size_t maxPerFunction = 8; // distinct sets of constant arguments specialized per function body
+};
+
+struct SpecializerStats {
+	size_t specialized = 0; // residual functions built
+	size_t calls = 0;       // calls made through one
+	size_t skipped = 0;     // calls with constant arguments to a body that already had maxPerFunction
+};
+
+// per thread, like jitStats
+extern thread_local SpecializerStats specializerStats;
+
+// @brief a function body partially evaluated for the literal arguments of a call site: the
+// parameters they are passed to are replaced by the literals, and the result is folded and
+// typed like -O2. A parameter the body rebinds with let is left a parameter. The residual
+// takes the remaining arguments, in their original order
+class Specialization {
+public:
+	std::vector<Identifier*> parameters; // the parameters still bound when called
+	BlockStatement* body = nullptr;
+	std::vector<size_t> kept;            // which of the call's arguments they are bound to
+
+	// nullptr when no parameter of function can be replaced by the constants at site
+	static std::shared_ptr<const Specialization> build(Function* function, CallExpression* site);
+
+	// binds the parameters in env, the frame the residual body runs in for a call with args
+	void bindArguments(Environment& env, Arguments args) const;
+
+	// the residual as a function literal
+	std::string string() const;
+
+private:
+	std::unique_ptr<Program> residual; // a single statement, the residual function literal
+};
+
+// the specialization of function for the constant arguments at site, built on first use and cached
+// on the function's body; nullptr when the call should be made as usual
+const Specialization* specialize(Function* function, CallExpression* site, const SpecializerConfig& config);
+
+void printSpecializerStats(std::ostream& out, const SpecializerStats& stats);
+
+
+#endif // !SPECIALIZER_HPP
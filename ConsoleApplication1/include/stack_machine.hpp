@@ -0,0 +1,21 @@
+#ifndef STACK_MACHINE_HPP
+#define STACK_MACHINE_HPP
+
+#include <cstddef>
+#include <memory>
+#include "object.hpp"
+#include "ast.hpp"
+
+struct StackMachineConfig {
+	size_t maxDepth = 100000; // nested Monkey calls allowed before "stack depth exceeded"
+};
+
+// @brief evaluation mode that keeps its continuations on a growable heap-allocated stack
+// instead of the native one. Same semantics as eval(), including tail calls (which do not
+// count towards the depth), but deep recursion only costs heap memory, and going past
+// config.maxDepth produces an Error ("stack depth exceeded") instead of crashing the host.
+ObjectRef evalOnHeapStack(Node* node, EnvironmentRef env,
+	const StackMachineConfig& config = StackMachineConfig());
+
+
+#endif // !STACK_MACHINE_HPP
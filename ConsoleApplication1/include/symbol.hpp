@@ -0,0 +1,28 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+
+#include <cstdint>
+#include <string>
+
+// @brief a name interned once, when the node naming it is built, so that environments
+// compare and hash names as integers. Symbols are never freed, and the same name is always
+// the same symbol. The table is shared by the whole process and safe to use from any thread
+using Symbol = uint32_t;
+
+// no name has it: marks the free slots of an environment
+constexpr Symbol noSymbol = UINT32_MAX;
+
+Symbol intern(const std::string& name);
+
+// the symbol of name, noSymbol when it was never interned (so nothing can be bound to it)
+Symbol findSymbol(const std::string& name);
+
+const std::string& symbolName(Symbol symbol);
+
+// @brief the bit a symbol sets in Environment::nameMask, a cheap filter for "might this environment bind it"
+inline uint64_t symbolBit(Symbol symbol) {
+	return uint64_t(1) << (symbol & 63);
+}
+
+
+#endif // !SYMBOL_HPP
@@ -0,0 +1,48 @@
+#ifndef TEST_HELPERS_HPP
+#define TEST_HELPERS_HPP
+
+#include <memory>
+#include <string>
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "ast.hpp"
+#include "object.hpp"
+#include "evaluator.hpp"
+#include "gc.hpp"
+#include "optimizer.hpp"
+
+// helpers shared by the test files; each file keeps the ones only it needs
+
+inline std::unique_ptr<Program> parse(const std::string& input) {
+	auto l = std::make_unique<Lexer>(input);
+	Parser p(l);
+	return p.parseProgram();
+}
+
+inline std::string describe(Object* obj) {
+	return obj ? obj->Type() + " " + obj->Inspect() : "nullptr";
+}
+
+// the value of input after the passes of optimizationLevel, evaluated by an interpreter of its own
+inline std::string evaluated(const std::string& input, const GcConfig& config, int optimizationLevel = 0) {
+	std::unique_ptr<Program> program = parse(input);
+	PassManager(optimizationLevel).run(*program);
+
+	Heap heap(config);
+	return describe(eval(program.get(), heap.newEnvironment(nullptr)).get());
+}
+
+inline std::string evaluated(const std::string& input, int optimizationLevel = 0) {
+	return evaluated(input, GcConfig(), optimizationLevel);
+}
+
+// evaluated by an interpreter with one of its settings (&GcConfig::memo, say) switched on or off
+template <typename Setting>
+std::string evaluated(const std::string& input, Setting GcConfig::* setting, bool enabled, int optimizationLevel = 0) {
+	GcConfig config;
+	(config.*setting).enabled = enabled;
+	return evaluated(input, config, optimizationLevel);
+}
+
+
+#endif // !TEST_HELPERS_HPP
@@ -0,0 +1,41 @@
+#ifndef TYPE_INFERENCE_HPP
+#define TYPE_INFERENCE_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include "ast.hpp"
+#include "optimizer.hpp"
+
+// @brief flow-based inference that sets Expression::staticType wherever the type is provable.
+// Literals are typed; a name is typed after a let of a typed value in the same scope, until
+// another let (or an if branch) may rebind it; operators are typed when their operands are and
+// they can't fail (so 5 / x is only typed for a non-zero literal x). Parameters, free variables
+// of a function and call results stay Unknown. Runs last, since it annotates the final tree
+class TypeInference : public Pass {
+public:
+	std::string name() const override {
+		return "type-inference";
+	};
+
+	// returns how many expressions were typed
+	size_t run(Program& program) override;
+};
+
+struct TypeCoverage {
+	size_t expressions = 0;
+	size_t typed = 0;
+
+	TypeCoverage& operator+=(const TypeCoverage& other) {
+		expressions += other.expressions;
+		typed += other.typed;
+		return *this;
+	}
+};
+
+// counts the expressions under root and those of them with a static type
+TypeCoverage collectTypeCoverage(Node* root);
+void printTypeCoverage(std::ostream& out, const TypeCoverage& coverage);
+
+
+#endif // !TYPE_INFERENCE_HPP